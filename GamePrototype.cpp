@@ -3,6 +3,8 @@
 #include <iomanip>
 #include <bits/stdc++.h>
 
+#include "engine.h"
+
 using namespace std;
 
 int main()
@@ -11,96 +13,76 @@ int main()
     bool gamestart = true;
     string guess;
     string guessedletters = "-----";
-    string enteredletter;
     char restartgame = 'Y';
     bool newgame = true;
-    bool gamedone = false;
 
     string players[] = {"player1", "player2"};
-    int turncount = 0;
-    int rounds = 1;
-    int playerscore[] = {0, 0};
     int order[] = {0, 1};
+    engine_game_t game;
 
     while (gamestart)
     {
         if (newgame == true)
         {
             // Reset all variables
-            rounds = 1;
-            turncount = 0;
-            for (int i=0; i <= 2; i++)
-            {
-                playerscore[i] = 0;
-            }
             guessedletters = "-----";
             wordtoguess = "-----";
             newgame = false;
-            gamedone = false;
 
             cout << "\nInput a 5 letter word." << endl;
             cin >> wordtoguess;
 
-            while (wordtoguess.length() < 5 || wordtoguess.length() > 5)
+            while (wordtoguess.length() != ENGINE_WORD_LEN)
             {
                 cout << "The word to guess is too short/long. Input a 5 letter word" << endl;
                 cin >> wordtoguess;
             }
 
             transform(wordtoguess.begin(), wordtoguess.end(), wordtoguess.begin(), ::toupper);
+            engine_new_game(&game, wordtoguess.c_str(), ENGINE_WORD_LEN);
         }
 
         cout << "\nA new round begins." << endl;
 
-        for (int i=0; i <= 4; i++)
+        // Same rules as the server: one guess per position, players alternate
+        guessedletters = game.display;
+        int pass = game.pass;
+        while (!game.over && game.pass == pass)
         {
-            if (guessedletters[i] != wordtoguess[i])
+            int i = game.pos;
+            cout << endl << setw(22) << "Round " << game.pass + 1 << endl;
+            cout << "\n----------This is " << players[game.turn - 1] << " turn----------" << endl << endl;
+            cout << setw(16) << guessedletters[0] << " " << guessedletters[1] << " " << guessedletters[2] << " " << guessedletters[3] << " " << guessedletters[4] << endl;
+            cout << setw(16 + (i*2)) << "^" << endl;
+
+            cout << "\nInput letter: ";
+            cin >> guess;
+            char letter = (char)toupper(guess[0]);
+
+            engine_result_t result = engine_apply_guess(&game, letter, NULL);
+            if (result == ENGINE_CORRECT)
             {
-                cout << endl << setw(22) << "Round " << rounds << endl;
-                cout << "\n----------This is " << players[turncount % 2] << " turn----------" << endl << endl;
-                cout << setw(16) << guessedletters[0] << " " << guessedletters[1] << " " << guessedletters[2] << " " << guessedletters[3] << " " << guessedletters[4] << endl;
-                cout << setw(16 + (i*2)) << "^" << endl;
-
-                cout << "\nInput letter: ";
-                cin >> guess;
-                guessedletters[i] = guess[0];
-                transform(guessedletters.begin(), guessedletters.end(), guessedletters.begin(), ::toupper);
-            
-                if (guessedletters[i] != wordtoguess[i])
-                {
-                    for (int j=0; j <= 4; j++)
-                    {
-                        if (guessedletters[i] == wordtoguess[j])
-                        {
-                            guessedletters[i] = '*';
-                        }
-                    }
-                }
-                else
-                {
-                    playerscore[turncount % 2] += 1;
-                }
-
-                if (guessedletters[i] != '*' && guessedletters[i] != wordtoguess[i])
-                {
-                    guessedletters[i] = '_';
-                }
-
-                turncount += 1;
+                guessedletters[i] = letter;
             }
-
-            cout << "THE I COUNT " << i << endl;
-            if (i == 4)
+            else if (result == ENGINE_PRESENT)
+            {
+                guessedletters[i] = '*';
+            }
+            else
             {
-                rounds += 1;
+                guessedletters[i] = '_';
             }
         }
 
-        if (guessedletters == wordtoguess)
+        if (game.over && game.revealed == ENGINE_WORD_LEN)
         {
             cout << "\n\nYou guessed the word. Congrats!" << endl;
             cout << "\nThe word is " << wordtoguess << endl;
 
+            engine_snapshot_t snap;
+            engine_snapshot(&game, &snap);
+            int playerscore[] = {snap.score_a, snap.score_b};
+
             for (int i = 0; i < 2 - 1; i++)
             {
                 for (int j = i + 1; j < 2; j++)
@@ -123,27 +105,14 @@ int main()
 
             // Declare winner
             cout << "\nWinner: " << players[order[0]] << endl;
-
-            gamedone = true;
         }
-        else if (rounds > 5)
+        else if (game.over)
         {
             cout << "\n\nYou didn't guess the word. Meh..." << endl;
-
-            for (int i=0; i <= 4; i++)
-            {
-                if (guessedletters[i] != wordtoguess[i])
-                {
-                    guessedletters[i] = '_';
-                }
-            }
-
             cout << "\nThe word is " << wordtoguess << endl;
-
-            gamedone = true;
         }
 
-        if (gamedone)
+        if (game.over)
         {
             cout << "\nWould you like another game? (Y/N)" << endl;
             cin >> restartgame;
@@ -162,4 +131,4 @@ int main()
     }
 
     return 0;
-}
\ No newline at end of file
+}
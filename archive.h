@@ -0,0 +1,59 @@
+// archive.h - Compact per-game archive record (games.arc)
+//
+// One fixed-size record per completed game, appended by the server when it
+// builds GAME_OVER. Fixed records let readers mmap the file and split it
+// between threads at any record boundary.
+//
+//   head       : secret word (25 bits, 5 x 5-bit letters, A=0, position 0 in
+//                the low bits) | nguesses << 25 (5 bits) | winner << 30 (2 bits)
+//   guess[i]   : letter (5 bits) | result << 5 (2 bits) | guesser << 7 (0 = A, 1 = B)
+//   think_ms[i]: YOUR_TURN -> GUESS delay, saturated at 65535
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdint.h>
+
+#define ARC_WORD_LEN    5
+#define ARC_MAX_GUESSES 25          // 5 passes x 5 positions
+
+enum { ARC_ABSENT = 0, ARC_PRESENT = 1, ARC_CORRECT = 2 };
+
+typedef struct {
+    uint32_t head;
+    uint32_t end_time;              // unix seconds
+    uint32_t player_a;              // score_name_hash() of the guessers' names
+    uint32_t player_b;
+    uint8_t score_a;
+    uint8_t score_b;
+    uint8_t passes;
+    uint8_t flags;                  // ARC_FLAG_*
+    uint8_t guess[ARC_MAX_GUESSES];
+    uint8_t reserved;
+    uint16_t think_ms[ARC_MAX_GUESSES];
+} arc_game_t;
+
+#define ARC_FLAG_SOLVED 0x01        // every position revealed
+
+_Static_assert(sizeof(arc_game_t) == 96, "arc_game_t layout changed");
+
+static inline uint32_t arc_pack_word(const char *w) {
+    uint32_t v = 0;
+    for (int i = 0; i < ARC_WORD_LEN; i++) v |= (uint32_t)(w[i] - 'A') << (5 * i);
+    return v;
+}
+
+static inline void arc_unpack_word(uint32_t v, char out[ARC_WORD_LEN + 1]) {
+    for (int i = 0; i < ARC_WORD_LEN; i++) out[i] = (char)('A' + ((v >> (5 * i)) & 31u));
+    out[ARC_WORD_LEN] = '\0';
+}
+
+static inline uint32_t arc_word(const arc_game_t *g)     { return g->head & 0x1FFFFFFu; }
+static inline int      arc_nguesses(const arc_game_t *g) { return (int)((g->head >> 25) & 31u); }
+static inline int      arc_winner(const arc_game_t *g)   { return (int)(g->head >> 30); }
+
+static inline uint8_t arc_pack_guess(char letter, int result, int guesser) {
+    return (uint8_t)((unsigned)(letter - 'A') | ((unsigned)result << 5) | ((unsigned)(guesser == 2) << 7));
+}
+
+#endif
@@ -0,0 +1,252 @@
+// arcq.c - Multithreaded queries over the games.arc archive
+// Build: gcc -O2 -Wall -Wextra -pedantic -pthread arcq.c -o arcq
+//
+// Usage:
+//   ./arcq <query> [games.arc] [threads]
+// Queries:
+//   summary      games, solve/draw rates, guesses and think time
+//   words        per secret word: games, solved %, A/B/draw split
+//   hours        games per hour (UTC)
+//   firstmove    win rate of the guesser who moved first (always A) by first result
+//
+// The archive is mmapped and split into equal record ranges; each thread
+// aggregates into its own table and the tables are merged at the end.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "archive.h"
+
+#define MAX_THREADS 64
+#define NCOUNT 5
+
+// Open-addressed uint32 key -> counters map, one per thread
+typedef struct {
+    uint32_t key;
+    uint32_t used;
+    uint64_t c[NCOUNT];
+} bucket_t;
+
+typedef struct {
+    bucket_t *b;
+    size_t cap;
+    size_t n;
+} table_t;
+
+typedef enum { Q_SUMMARY, Q_WORDS, Q_HOURS, Q_FIRSTMOVE } query_t;
+
+typedef struct {
+    const arc_game_t *games;
+    size_t begin;
+    size_t end;
+    query_t q;
+    table_t t;
+} worker_t;
+
+static uint32_t mix32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint64_t *table_get(table_t *t, uint32_t key);
+
+static void table_grow(table_t *t) {
+    bucket_t *old = t->b;
+    size_t old_cap = t->cap;
+    t->cap = old_cap ? old_cap * 2 : 1024;
+    t->b = calloc(t->cap, sizeof(bucket_t));
+    if (!t->b) { perror("calloc"); exit(1); }
+    t->n = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (!old[i].used) continue;
+        memcpy(table_get(t, old[i].key), old[i].c, sizeof(old[i].c));
+    }
+    free(old);
+}
+
+static uint64_t *table_get(table_t *t, uint32_t key) {
+    if ((t->n + 1) * 2 > t->cap) table_grow(t);
+    size_t mask = t->cap - 1;
+    size_t i = mix32(key) & mask;
+    while (t->b[i].used) {
+        if (t->b[i].key == key) return t->b[i].c;
+        i = (i + 1) & mask;
+    }
+    t->b[i].used = 1;
+    t->b[i].key = key;
+    t->n++;
+    return t->b[i].c;
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = (worker_t*)arg;
+    for (size_t i = w->begin; i < w->end; i++) {
+        const arc_game_t *g = &w->games[i];
+        int winner = arc_winner(g);
+        uint64_t *c;
+
+        switch (w->q) {
+        case Q_SUMMARY: {
+            c = table_get(&w->t, 0);
+            int ng = arc_nguesses(g);
+            uint64_t think = 0;
+            for (int k = 0; k < ng; k++) think += g->think_ms[k];
+            c[0] += 1;
+            c[1] += (g->flags & ARC_FLAG_SOLVED) ? 1 : 0;
+            c[2] += (winner == 0) ? 1 : 0;
+            c[3] += (uint64_t)ng;
+            c[4] += think;
+            break;
+        }
+        case Q_WORDS:
+            c = table_get(&w->t, arc_word(g));
+            c[0] += 1;
+            c[1] += (g->flags & ARC_FLAG_SOLVED) ? 1 : 0;
+            c[2 + (winner == 1 ? 0 : (winner == 2 ? 1 : 2))] += 1;
+            break;
+        case Q_HOURS:
+            c = table_get(&w->t, g->end_time / 3600u);
+            c[0] += 1;
+            break;
+        case Q_FIRSTMOVE:
+            if (arc_nguesses(g) == 0) break;
+            c = table_get(&w->t, (uint32_t)((g->guess[0] >> 5) & 3u));
+            c[0] += 1;
+            c[1 + (winner == 1 ? 0 : (winner == 2 ? 1 : 2))] += 1;
+            break;
+        }
+    }
+    return NULL;
+}
+
+static int cmp_bucket_key(const void *x, const void *y) {
+    const bucket_t *a = (const bucket_t*)x;
+    const bucket_t *b = (const bucket_t*)y;
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+static double pct(uint64_t a, uint64_t b) {
+    return b ? 100.0 * (double)a / (double)b : 0.0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <summary|words|hours|firstmove> [games.arc] [threads]\n", argv[0]);
+        return 1;
+    }
+    query_t q;
+    if (strcmp(argv[1], "summary") == 0) q = Q_SUMMARY;
+    else if (strcmp(argv[1], "words") == 0) q = Q_WORDS;
+    else if (strcmp(argv[1], "hours") == 0) q = Q_HOURS;
+    else if (strcmp(argv[1], "firstmove") == 0) q = Q_FIRSTMOVE;
+    else { fprintf(stderr, "Unknown query: %s\n", argv[1]); return 1; }
+
+    const char *path = (argc > 2) ? argv[2] : "games.arc";
+    int nthreads = (argc > 3) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror("open"); return 1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { perror("fstat"); return 1; }
+    size_t n = (size_t)st.st_size / sizeof(arc_game_t);
+    if (n == 0) { printf("No games in %s.\n", path); close(fd); return 0; }
+
+    const arc_game_t *games = mmap(NULL, n * sizeof(arc_game_t), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (games == MAP_FAILED) { perror("mmap"); return 1; }
+    close(fd);
+    madvise((void*)games, n * sizeof(arc_game_t), MADV_SEQUENTIAL);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    worker_t w[MAX_THREADS];
+    pthread_t th[MAX_THREADS];
+    memset(w, 0, sizeof(w));
+    for (int t = 0; t < nthreads; t++) {
+        w[t].games = games;
+        w[t].begin = n * (size_t)t / (size_t)nthreads;
+        w[t].end = n * (size_t)(t + 1) / (size_t)nthreads;
+        w[t].q = q;
+        pthread_create(&th[t], NULL, worker_main, &w[t]);
+    }
+    for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+
+    // Merge into thread 0's table
+    table_t *all = &w[0].t;
+    for (int t = 1; t < nthreads; t++) {
+        for (size_t i = 0; i < w[t].t.cap; i++) {
+            const bucket_t *b = &w[t].t.b[i];
+            if (!b->used) continue;
+            uint64_t *c = table_get(all, b->key);
+            for (int k = 0; k < NCOUNT; k++) c[k] += b->c[k];
+        }
+        free(w[t].t.b);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    // Compact and sort by key for stable output
+    size_t m = 0;
+    for (size_t i = 0; i < all->cap; i++) {
+        if (all->b[i].used) all->b[m++] = all->b[i];
+    }
+    qsort(all->b, m, sizeof(bucket_t), cmp_bucket_key);
+
+    for (size_t i = 0; i < m; i++) {
+        const uint64_t *c = all->b[i].c;
+        switch (q) {
+        case Q_SUMMARY:
+            printf("games=%llu solved=%.1f%% draws=%.1f%% guesses/game=%.2f think_ms/guess=%.0f\n",
+                   (unsigned long long)c[0], pct(c[1], c[0]), pct(c[2], c[0]),
+                   c[0] ? (double)c[3] / (double)c[0] : 0.0,
+                   c[3] ? (double)c[4] / (double)c[3] : 0.0);
+            break;
+        case Q_WORDS: {
+            char word[ARC_WORD_LEN + 1];
+            arc_unpack_word(all->b[i].key, word);
+            printf("%s games=%llu solved=%.1f%% winA=%.1f%% winB=%.1f%% draw=%.1f%%\n",
+                   word, (unsigned long long)c[0], pct(c[1], c[0]),
+                   pct(c[2], c[0]), pct(c[3], c[0]), pct(c[4], c[0]));
+            break;
+        }
+        case Q_HOURS: {
+            time_t h = (time_t)all->b[i].key * 3600;
+            struct tm tm;
+            gmtime_r(&h, &tm);
+            printf("%04d-%02d-%02d %02d:00 games=%llu\n",
+                   tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                   (unsigned long long)c[0]);
+            break;
+        }
+        case Q_FIRSTMOVE: {
+            static const char *names[] = { "ABSENT", "PRESENT", "CORRECT", "?" };
+            printf("first=%s games=%llu winA=%.1f%% winB=%.1f%% draw=%.1f%%\n",
+                   names[all->b[i].key & 3u], (unsigned long long)c[0],
+                   pct(c[1], c[0]), pct(c[2], c[0]), pct(c[3], c[0]));
+            break;
+        }
+        }
+    }
+
+    fprintf(stderr, "Scanned %zu games (%.1f MB) in %.3f s with %d threads (%.2f GB/s).\n",
+            n, (double)(n * sizeof(arc_game_t)) / 1e6, secs, nthreads,
+            secs > 0 ? (double)(n * sizeof(arc_game_t)) / secs / 1e9 : 0.0);
+
+    free(all->b);
+    munmap((void*)games, n * sizeof(arc_game_t));
+    return 0;
+}
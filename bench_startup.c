@@ -0,0 +1,131 @@
+// bench_startup.c - Score store startup cost: scores.txt scan vs scores.idx mmap
+// Build: gcc -O2 -Wall -Wextra -pedantic bench_startup.c -o bench_startup
+//
+// Usage:
+//   ./bench_startup [players] [lookups]
+// Example (what `make bench-startup` runs):
+//   ./bench_startup 10000000 1000000
+//
+// Generates synthetic players, writes them both as a legacy scores.txt and as
+// a scores.idx, then times what the server pays before it can serve:
+//   - the old path: fscanf over every line of scores.txt
+//   - the new path: score_index_open() (mmap + header check)
+// plus random lookups against the mapped index (the lazy fallback path).
+// Files are written to bench_scores.{txt,idx} and removed afterwards.
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "score_index.h"
+
+#define TXT_PATH "bench_scores.txt"
+#define IDX_PATH "bench_scores.idx"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t xorshift(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return *s = x;
+}
+
+static void synth_name(char *out, size_t cap, uint64_t i) {
+    snprintf(out, cap, "player%llu", (unsigned long long)i);
+}
+
+int main(int argc, char **argv) {
+    uint64_t players = (argc > 1) ? strtoull(argv[1], NULL, 10) : 10000000ull;
+    uint64_t lookups = (argc > 2) ? strtoull(argv[2], NULL, 10) : 1000000ull;
+    if (players == 0) players = 1;
+
+    // --- generate ---
+    double t0 = now_sec();
+    score_idx_rec_t *recs = malloc(players * sizeof(*recs));
+    if (!recs) { perror("malloc"); return 1; }
+
+    FILE *txt = fopen(TXT_PATH, "w");
+    if (!txt) { perror("fopen"); return 1; }
+    setvbuf(txt, NULL, _IOFBF, 1 << 20);
+
+    uint64_t seed = 88172645463325252ull;
+    for (uint64_t i = 0; i < players; i++) {
+        score_idx_rec_t *r = &recs[i];
+        memset(r, 0, sizeof(*r));
+        synth_name(r->name, sizeof(r->name), i);
+        r->hash = score_name_hash(r->name);
+        r->wins = (int32_t)(xorshift(&seed) % 500);
+        r->slot = 1 + (int32_t)(i & 1);
+        r->rating = 1000.0 + (double)(xorshift(&seed) % 1000);
+        fprintf(txt, "%d %d %s %.1f\n", r->slot, r->wins, r->name, r->rating);
+    }
+    fclose(txt);
+    double t_gen = now_sec() - t0;
+
+    t0 = now_sec();
+    if (score_index_write_merged(IDX_PATH, NULL, recs, players) != 0) {
+        perror("score_index_write_merged");
+        return 1;
+    }
+    double t_build = now_sec() - t0;
+    free(recs);
+
+    // --- old startup: parse every line ---
+    t0 = now_sec();
+    FILE *f = fopen(TXT_PATH, "r");
+    if (!f) { perror("fopen"); return 1; }
+    char buf[256];
+    uint64_t parsed = 0;
+    long long wins_sum = 0;
+    while (fgets(buf, sizeof(buf), f)) {
+        int pid, wins;
+        char name[SCORE_IDX_NAME_LEN];
+        double rating;
+        if (sscanf(buf, "%d %d %31s %lf", &pid, &wins, name, &rating) < 3) continue;
+        wins_sum += wins;
+        parsed++;
+    }
+    fclose(f);
+    double t_txt = now_sec() - t0;
+
+    // --- new startup: map the index ---
+    t0 = now_sec();
+    score_index_t ix;
+    if (score_index_open(&ix, IDX_PATH) != 0 || ix.count != players) {
+        fprintf(stderr, "index open failed\n");
+        return 1;
+    }
+    double t_open = now_sec() - t0;
+
+    // --- lazy lookups (cold pages on first touch) ---
+    t0 = now_sec();
+    uint64_t found = 0;
+    for (uint64_t i = 0; i < lookups; i++) {
+        char name[SCORE_IDX_NAME_LEN];
+        synth_name(name, sizeof(name), xorshift(&seed) % (players * 2));   // ~half miss
+        if (score_index_find(&ix, name)) found++;
+    }
+    double t_look = now_sec() - t0;
+    score_index_close(&ix);
+
+    printf("players              %llu\n", (unsigned long long)players);
+    printf("generate (txt+recs)  %8.3f s\n", t_gen);
+    printf("build scores.idx     %8.3f s\n", t_build);
+    printf("startup: scan txt    %8.3f s  (%llu lines, checksum %lld)\n",
+           t_txt, (unsigned long long)parsed, wins_sum);
+    printf("startup: open idx    %8.6f s\n", t_open);
+    printf("index lookups        %8.3f s  (%llu lookups, %.0f ns each, %llu hits)\n",
+           t_look, (unsigned long long)lookups,
+           lookups ? t_look * 1e9 / (double)lookups : 0.0, (unsigned long long)found);
+
+    remove(TXT_PATH);
+    remove(IDX_PATH);
+    return 0;
+}
@@ -0,0 +1,304 @@
+// bot.c - Dictionary-filtering AI guesser (see bot.h)
+//
+// Bit i of every bitset is word i; block k holds words 128k..128k+127.
+// Feedback keeps a candidate iff (at ^ flip_at) & (has ^ flip_has) is set:
+//   CORRECT  at           (has is implied)
+//   PRESENT  ~at & has
+//   ABSENT   ~at & ~has   (== ~has, since at is a subset of has)
+// so the filter is one branch-free kernel whatever the result was.
+
+#include "bot.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define BOT_BLOCK_BITS 128
+
+// Counting is popcount-bound and SSE2 has no popcount, so the counting
+// loops get a POPCNT clone picked at load time where the CPU has one
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define BOT_POPCNT_CLONES __attribute__((target_clones("popcnt", "default")))
+#else
+#define BOT_POPCNT_CLONES
+#endif
+
+typedef struct {
+    uint64_t *out;
+    size_t n;
+} bot_collect_t;
+
+static void bot_collect(const char *w, void *ctx) {
+    bot_collect_t *c = (bot_collect_t*)ctx;
+    int ok;
+    c->out[c->n++] = dict_pack(w, (int)strlen(w), &ok);
+}
+
+static inline int bot_letter_at(uint64_t key, int pos) {
+    return (int)(((key - 1) >> (5 * pos)) & 31u);
+}
+
+static inline bot_block_t *bot_at(const bot_t *b, int pos, int letter) {
+    return b->at + ((size_t)pos * ENGINE_ALPHABET + (size_t)letter) * b->nblocks;
+}
+
+static inline void bot_set_bit(bot_block_t *set, size_t i) {
+    set[i / BOT_BLOCK_BITS].w[(i / 64) & 1] |= 1ull << (i % 64);
+}
+
+static uint64_t bot_rand(bot_t *b) {
+    uint64_t x = b->rng;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return b->rng = x;
+}
+
+int bot_init(bot_t *b, const dict_t *d, int len, uint64_t seed) {
+    memset(b, 0, sizeof(*b));
+    if (!engine_len_supported(len)) return -1;
+    size_t cap = (size_t)dict_count(d, len);
+    if (cap == 0) return -1;
+
+    b->len = len;
+    b->rng = seed ? seed : 0x9E3779B97F4A7C15ull;
+    b->words = malloc(cap * sizeof(*b->words));
+    if (!b->words) return -1;
+    bot_collect_t c = { b->words, 0 };
+    dict_foreach(d, len, bot_collect, &c);
+    b->nwords = c.n;
+    if (b->nwords == 0) { bot_free(b); return -1; }
+
+    b->nblocks = (b->nwords + BOT_BLOCK_BITS - 1) / BOT_BLOCK_BITS;
+    size_t sets = (size_t)len * ENGINE_ALPHABET + ENGINE_ALPHABET + 1;
+    bot_block_t *all = aligned_alloc(16, sets * b->nblocks * sizeof(bot_block_t));
+    if (!all) { bot_free(b); return -1; }
+    memset(all, 0, sets * b->nblocks * sizeof(bot_block_t));
+    b->at = all;
+    b->has = all + (size_t)len * ENGINE_ALPHABET * b->nblocks;
+    b->alive = b->has + ENGINE_ALPHABET * b->nblocks;
+
+    for (size_t i = 0; i < b->nwords; i++) {
+        uint32_t seen = 0;
+        for (int p = 0; p < len; p++) {
+            int l = bot_letter_at(b->words[i], p);
+            bot_set_bit(bot_at(b, p, l), i);
+            seen |= 1u << l;
+        }
+        for (int l = 0; l < ENGINE_ALPHABET; l++) {
+            if (!((seen >> l) & 1u)) continue;
+            bot_set_bit(b->has + (size_t)l * b->nblocks, i);
+            b->total_has[l]++;
+        }
+    }
+    for (int p = 0; p < len; p++) {
+        for (size_t i = 0; i < b->nwords; i++) b->total_at[p][bot_letter_at(b->words[i], p)]++;
+    }
+
+    bot_new_game(b);
+    return 0;
+}
+
+void bot_free(bot_t *b) {
+    free(b->words);
+    free(b->at);
+    memset(b, 0, sizeof(*b));
+}
+
+void bot_new_game(bot_t *b) {
+    memset(b->alive, 0xFF, b->nblocks * sizeof(bot_block_t));
+    size_t tail = b->nwords % BOT_BLOCK_BITS;   // clear bits past the last word
+    if (tail) {
+        bot_block_t *last = &b->alive[b->nblocks - 1];
+        last->w[1] = (tail > 64) ? ~0ull >> (128 - tail) : 0;
+        last->w[0] = (tail >= 64) ? ~0ull : ~0ull >> (64 - tail);
+    }
+    b->alive_count = b->nwords;
+    b->lo = 0;
+    b->hi = b->nblocks;
+    b->absent_mask = 0;
+    memset(b->tried, 0, sizeof(b->tried));
+    memset(b->known, 0, sizeof(b->known));
+}
+
+// alive &= (at ^ fa) & (has ^ fh) over [lo, hi); returns survivors and
+// narrows [lo, hi) to the blocks that still have any
+BOT_POPCNT_CLONES
+static size_t bot_filter(bot_t *b, const bot_block_t *at, const bot_block_t *has,
+                         uint64_t fa, uint64_t fh) {
+    size_t count = 0, lo = b->hi, hi = b->lo;
+#if defined(__SSE2__)
+    const __m128i va = _mm_set1_epi64x((long long)fa);
+    const __m128i vh = _mm_set1_epi64x((long long)fh);
+#endif
+    for (size_t k = b->lo; k < b->hi; k++) {
+        bot_block_t *a = &b->alive[k];
+#if defined(__SSE2__)
+        __m128i x = _mm_xor_si128(_mm_load_si128((const __m128i*)&at[k]), va);
+        __m128i y = _mm_xor_si128(_mm_load_si128((const __m128i*)&has[k]), vh);
+        __m128i v = _mm_and_si128(_mm_load_si128((const __m128i*)a), _mm_and_si128(x, y));
+        _mm_store_si128((__m128i*)a, v);
+#else
+        a->w[0] &= (at[k].w[0] ^ fa) & (has[k].w[0] ^ fh);
+        a->w[1] &= (at[k].w[1] ^ fa) & (has[k].w[1] ^ fh);
+#endif
+        size_t n = (size_t)__builtin_popcountll(a->w[0]) + (size_t)__builtin_popcountll(a->w[1]);
+        if (n) {
+            if (k < lo) lo = k;
+            hi = k + 1;
+        }
+        count += n;
+    }
+    b->lo = (lo < hi) ? lo : 0;
+    b->hi = (lo < hi) ? hi : 0;
+    return count;
+}
+
+void bot_observe(bot_t *b, int pos, char letter, engine_result_t r) {
+    unsigned l = (unsigned)(letter - 'A');
+    if (l >= ENGINE_ALPHABET || pos < 0 || pos >= b->len) return;
+
+    b->tried[pos] |= 1u << l;
+    if (r == ENGINE_ABSENT) b->absent_mask |= 1u << l;
+    if (r == ENGINE_CORRECT) b->known[pos] = letter;
+    if (b->strategy != BOT_INFO) return;
+
+    uint64_t fa = (r == ENGINE_CORRECT) ? 0 : ~0ull;
+    uint64_t fh = (r == ENGINE_ABSENT) ? ~0ull : 0;
+    b->alive_count = bot_filter(b, bot_at(b, pos, (int)l), b->has + (size_t)l * b->nblocks, fa, fh);
+}
+
+// Candidates with letter L at pos (n_at) and containing L (n_has), all L
+BOT_POPCNT_CLONES
+static void bot_count(const bot_t *b, int pos, uint64_t n_at[ENGINE_ALPHABET],
+                      uint64_t n_has[ENGINE_ALPHABET]) {
+    if (b->alive_count == b->nwords) {   // untouched board: counted once in bot_init()
+        for (int l = 0; l < ENGINE_ALPHABET; l++) {
+            n_at[l] = b->total_at[pos][l];
+            n_has[l] = b->total_has[l];
+        }
+        return;
+    }
+    memset(n_at, 0, ENGINE_ALPHABET * sizeof(uint64_t));
+    memset(n_has, 0, ENGINE_ALPHABET * sizeof(uint64_t));
+    size_t blocks = b->hi - b->lo;
+
+    // Few candidates spread over many blocks: walk the set bits instead
+    if (b->alive_count * (size_t)b->len < blocks * ENGINE_ALPHABET) {
+        for (size_t k = b->lo; k < b->hi; k++) {
+            for (int h = 0; h < 2; h++) {
+                for (uint64_t m = b->alive[k].w[h]; m; m &= m - 1) {
+                    uint64_t key = b->words[k * BOT_BLOCK_BITS + (size_t)h * 64 + (size_t)__builtin_ctzll(m)];
+                    uint32_t seen = 0;
+                    for (int p = 0; p < b->len; p++) seen |= 1u << bot_letter_at(key, p);
+                    n_at[bot_letter_at(key, pos)]++;
+                    for (; seen; seen &= seen - 1) n_has[__builtin_ctz(seen)]++;
+                }
+            }
+        }
+        return;
+    }
+
+    // Letter-major: each sum streams two bitsets against the (L1-resident)
+    // candidate blocks with the accumulator in a register
+    const bot_block_t *alive = b->alive;
+    size_t nb = b->nblocks, lo = b->lo, hi = b->hi;
+    for (int l = 0; l < ENGINE_ALPHABET; l++) {
+        const bot_block_t *x = bot_at(b, pos, l);
+        const bot_block_t *y = b->has + (size_t)l * nb;
+        uint64_t sa = 0, sh = 0;
+        for (size_t k = lo; k < hi; k++) {
+            sa += (uint64_t)__builtin_popcountll(alive[k].w[0] & x[k].w[0]) +
+                  (uint64_t)__builtin_popcountll(alive[k].w[1] & x[k].w[1]);
+            sh += (uint64_t)__builtin_popcountll(alive[k].w[0] & y[k].w[0]) +
+                  (uint64_t)__builtin_popcountll(alive[k].w[1] & y[k].w[1]);
+        }
+        n_at[l] = sa;
+        n_has[l] = sh;
+    }
+}
+
+static double bot_plogp(uint64_t c, double n) {
+    if (c == 0) return 0.0;
+    double p = (double)c / n;
+    return -p * log2(p);
+}
+
+// BOT_FREQ / BOT_RANDOM and the info bot's fallback: a revealed letter, else
+// the best (or a random) letter not yet ruled out at pos
+static char bot_choose_simple(bot_t *b, int pos, const uint32_t *weight) {
+    if (b->known[pos]) return b->known[pos];
+    uint32_t open = ~(b->absent_mask | b->tried[pos]) & ((1u << ENGINE_ALPHABET) - 1);
+    if (!open) return (char)('A' + (int)(bot_rand(b) % ENGINE_ALPHABET));
+
+    if (!weight) {
+        int k = (int)(bot_rand(b) % (uint64_t)__builtin_popcount(open));
+        while (k--) open &= open - 1;
+        return (char)('A' + __builtin_ctz(open));
+    }
+    int best = __builtin_ctz(open);
+    for (uint32_t m = open; m; m &= m - 1) {
+        int l = __builtin_ctz(m);
+        if (weight[l] > weight[best]) best = l;
+    }
+    return (char)('A' + best);
+}
+
+char bot_choose(bot_t *b, int pos) {
+    if (pos < 0 || pos >= b->len) pos = 0;
+
+    if (b->strategy == BOT_RANDOM) return bot_choose_simple(b, pos, NULL);
+    if (b->strategy == BOT_FREQ) return bot_choose_simple(b, pos, b->total_at[pos]);
+    if (b->alive_count == 0) return bot_choose_simple(b, pos, b->total_has);
+
+    uint64_t n_at[ENGINE_ALPHABET], n_has[ENGINE_ALPHABET];
+    bot_count(b, pos, n_at, n_has);
+
+    double n = (double)b->alive_count;
+    double best_h = -1.0;
+    uint64_t best_at = 0;
+    int best = 0, ties = 0;
+    for (int l = 0; l < ENGINE_ALPHABET; l++) {
+        double h = bot_plogp(n_at[l], n) + bot_plogp(n_has[l] - n_at[l], n) +
+                   bot_plogp(b->alive_count - n_has[l], n);
+        int better;
+        if (h > best_h + 1e-12) better = 1;
+        else if (h < best_h - 1e-12) better = 0;
+        else if (n_at[l] != best_at) better = n_at[l] > best_at;
+        else better = (bot_rand(b) % (uint64_t)++ties) == 0;   // reservoir over exact ties
+
+        if (better) {
+            if (h > best_h + 1e-12 || n_at[l] != best_at) ties = 1;
+            best_h = h;
+            best_at = n_at[l];
+            best = l;
+        }
+    }
+    return (char)('A' + best);
+}
+
+int bot_strategy_parse(const char *name, bot_strategy_t *out) {
+    for (int s = BOT_INFO; s <= BOT_RANDOM; s++) {
+        if (strcmp(name, bot_strategy_name((bot_strategy_t)s)) == 0) {
+            *out = (bot_strategy_t)s;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *bot_strategy_name(bot_strategy_t s) {
+    switch (s) {
+    case BOT_FREQ:   return "freq";
+    case BOT_RANDOM: return "random";
+    default:         return "info";
+    }
+}
+
+void bot_random_word(bot_t *b, char *out) {
+    uint64_t key = b->words[bot_rand(b) % b->nwords];
+    for (int p = 0; p < b->len; p++) out[p] = (char)('A' + bot_letter_at(key, p));
+    out[b->len] = '\0';
+}
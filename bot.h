@@ -0,0 +1,94 @@
+// bot.h - Dictionary-filtering AI guesser for the letter-per-position rules
+//
+// The bot keeps every dictionary word of the room's length that is still
+// consistent with the feedback seen so far (its own guesses and the
+// opponent's, both arrive in STATE result=), and picks the letter for the
+// current position whose CORRECT/PRESENT/ABSENT split of those candidates
+// has the highest entropy, i.e. the most expected information. Ties go to
+// the likelier CORRECT, so a position every candidate agrees on is played
+// for the point.
+//
+// The word list is stored bit-sliced: one bitset over all words per
+// (position, letter) and one per letter ("contains"). Applying feedback is
+// an AND/ANDNOT of two bitsets into the candidate set; scoring all 26
+// letters is one pass of masked popcounts. The filter runs 128 words per
+// step with SSE2 (scalar fallback elsewhere), counting uses POPCNT when the
+// CPU has it, and both touch only the blocks that still hold candidates.
+// Counts for the untouched board are cached, and a sparse candidate set is
+// counted word by word, so a decision against 100k words stays in the tens
+// of microseconds and falls fast as feedback arrives.
+//
+// Cheaper strategies share the same bookkeeping for benchmarks and
+// baselines: BOT_FREQ plays the letter most common at this position across
+// the dictionary, BOT_RANDOM any letter; both skip letters already ruled out
+// there and replay a revealed letter. Neither touches the bitsets.
+//
+// Like engine.h, a bot owns plain heap buffers set up by bot_init() and does
+// no I/O after it; one bot_t per player, not shared between threads.
+
+#ifndef BOT_H
+#define BOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dict.h"
+#include "engine.h"
+
+typedef enum {
+    BOT_INFO = 0,                       // max expected information (default)
+    BOT_FREQ,
+    BOT_RANDOM
+} bot_strategy_t;
+
+typedef struct {
+    uint64_t w[2];
+} bot_block_t;                          // 128 words' worth of bits
+
+typedef struct {
+    int len;
+    bot_strategy_t strategy;
+    size_t nwords;
+    size_t nblocks;                     // blocks per bitset
+    uint64_t *words;                    // dict_pack() keys, bit i <-> words[i]
+    bot_block_t *at;                    // [len][26] bitsets: letter L at position p
+    bot_block_t *has;                   // [26] bitsets: word contains L
+    uint32_t total_has[ENGINE_ALPHABET];    // words containing L
+    uint32_t total_at[ENGINE_MAX_WORD_LEN][ENGINE_ALPHABET];   // words with L at p
+
+    // Per game
+    bot_block_t *alive;                 // candidates consistent with all feedback
+    size_t alive_count;
+    size_t lo, hi;                      // alive blocks all lie in [lo, hi)
+    uint32_t absent_mask;               // letters seen ABSENT
+    uint32_t tried[ENGINE_MAX_WORD_LEN];    // letters guessed at each position
+    char known[ENGINE_MAX_WORD_LEN];    // CORRECT letter per position, 0 if unknown
+    uint64_t rng;                       // xorshift, breaks exact ties
+} bot_t;
+
+// Loads every len-letter word from d. Returns -1 if d has none (or on OOM).
+int bot_init(bot_t *b, const dict_t *d, int len, uint64_t seed);
+void bot_free(bot_t *b);
+
+// "info", "freq" or "random"; returns -1 for an unknown name
+int bot_strategy_parse(const char *name, bot_strategy_t *out);
+const char *bot_strategy_name(bot_strategy_t s);
+
+// Forget all feedback: every dictionary word is a candidate again
+void bot_new_game(bot_t *b);
+
+// Feedback for any guesser's move; pos is 0-based
+void bot_observe(bot_t *b, int pos, char letter, engine_result_t r);
+
+// Best letter ('A'..'Z') for 0-based pos. If the feedback ruled out every
+// dictionary word (secret not in the list), falls back to the most common
+// letter not yet tried there and not known ABSENT.
+char bot_choose(bot_t *b, int pos);
+
+// A uniformly random dictionary word (for taking the wordmaster slot);
+// out gets len letters + NUL
+void bot_random_word(bot_t *b, char *out);
+
+static inline size_t bot_candidates(const bot_t *b) { return b->alive_count; }
+
+#endif
@@ -0,0 +1,200 @@
+// botplay.c - AI player for the word guessing game (speaks client.c's protocol)
+// Build: make botplay   (gcc ... botplay.c bot.o -o botplay -lm)
+//
+// Usage:
+//   ./botplay <server_ip> <port> <name> [dict.idx]
+// Example (wordmaster and one human first, then the bot takes guesser 2):
+//   ./botplay 127.0.0.1 5000 Robo
+//
+// Guesser slot: every STATE (own and opponent moves) is fed to the bot as
+// feedback, every YOUR_TURN is answered with the bot's letter. Wordmaster
+// slot: answers ENTER_WORD with a random dictionary word. Runs until the
+// server disconnects, then prints decision-time stats.
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bot.h"
+
+static ssize_t send_all(int fd, const void *buf, size_t len) {
+    const char *p = (const char*)buf;
+    size_t off = 0;
+    while (off < len) {
+        ssize_t w = send(fd, p + off, len - off, 0);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (w == 0) return -1;
+        off += (size_t)w;
+    }
+    return (ssize_t)off;
+}
+
+static int send_line(int fd, const char *line) {
+    char buf[512];
+    snprintf(buf, sizeof(buf), "%s\n", line);
+    return (send_all(fd, buf, strlen(buf)) < 0) ? -1 : 0;
+}
+
+static ssize_t recv_line(int fd, char *out, size_t cap) {
+    size_t n = 0;
+    while (n + 1 < cap) {
+        char c;
+        ssize_t r = recv(fd, &c, 1, 0);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (r == 0) return 0;
+        if (c == '\n') break;
+        if (c == '\r') continue;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return (ssize_t)n;
+}
+
+static int connect_to(const char *ip, uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) { perror("socket"); exit(1); }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        fprintf(stderr, "Invalid IP: %s\n", ip);
+        exit(1);
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("connect");
+        exit(1);
+    }
+    return fd;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int field_int(const char *line, const char *key, int def) {
+    const char *p = strstr(line, key);
+    return p ? atoi(p + strlen(key)) : def;
+}
+
+static engine_result_t parse_result(const char *line) {
+    const char *p = strstr(line, "result=");
+    if (!p) return ENGINE_ABSENT;
+    p += 7;
+    if (strncmp(p, "CORRECT", 7) == 0) return ENGINE_CORRECT;
+    if (strncmp(p, "PRESENT", 7) == 0) return ENGINE_PRESENT;
+    return ENGINE_ABSENT;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4 && argc != 5) {
+        fprintf(stderr, "Usage: %s <server_ip> <port> <name> [dict.idx]\n", argv[0]);
+        return 1;
+    }
+    const char *ip = argv[1];
+    uint16_t port = (uint16_t)atoi(argv[2]);
+    const char *name = argv[3];
+    const char *dict_path = (argc == 5) ? argv[4] : "dict.idx";
+
+    dict_t dict;
+    if (dict_open(&dict, dict_path) != 0) {
+        fprintf(stderr, "Cannot open %s (build it with dictbuild).\n", dict_path);
+        return 1;
+    }
+
+    int fd = connect_to(ip, port);
+    char line[512];
+    if (recv_line(fd, line, sizeof(line)) <= 0) {
+        fprintf(stderr, "Server closed.\n");
+        return 1;
+    }
+    char msg[128];
+    snprintf(msg, sizeof(msg), "NAME %s", name);
+    send_line(fd, msg);
+
+    bot_t bot;
+    int ready = 0;
+    int games = 0;
+    uint64_t decisions = 0, total_ns = 0, max_ns = 0;
+
+    while (recv_line(fd, line, sizeof(line)) > 0) {
+        if (strncmp(line, "ROLE ", 5) == 0) {
+            if (strstr(line, " rules=word")) {
+                fprintf(stderr, "botplay only plays letter-rule rooms.\n");
+                break;
+            }
+            int len = field_int(line, "len=", ENGINE_WORD_LEN);
+            if (bot_init(&bot, &dict, len, (uint64_t)now_ns() ^ (uint64_t)getpid()) != 0) {
+                fprintf(stderr, "No %d-letter words in %s.\n", len, dict_path);
+                break;
+            }
+            ready = 1;
+            printf("%s (%zu candidate words)\n", line, bot.nwords);
+            continue;
+        }
+        if (!ready) continue;
+
+        if (strncmp(line, "STATE", 5) == 0) {
+            const char *g = strstr(line, "guess=");
+            int pos = field_int(line, " pos=", 0) - 1;
+            if (g) bot_observe(&bot, pos, g[6], parse_result(line));
+            continue;
+        }
+
+        if (strncmp(line, "YOUR_TURN", 9) == 0) {
+            int pos = field_int(line, " pos=", 1) - 1;
+            uint64_t t0 = now_ns();
+            char c = bot_choose(&bot, pos);
+            uint64_t dt = now_ns() - t0;
+            decisions++;
+            total_ns += dt;
+            if (dt > max_ns) max_ns = dt;
+
+            snprintf(msg, sizeof(msg), "GUESS %c", c);
+            send_line(fd, msg);
+            continue;
+        }
+
+        if (strncmp(line, "ENTER_WORD", 10) == 0) {
+            char w[ENGINE_MAX_WORD_LEN + 1];
+            bot_random_word(&bot, w);
+            snprintf(msg, sizeof(msg), "WORD %s", w);
+            send_line(fd, msg);
+            continue;
+        }
+
+        if (strncmp(line, "GAME_OVER", 9) == 0) {
+            printf("%s\n", line);
+            games++;
+            bot_new_game(&bot);
+            continue;
+        }
+    }
+
+    printf("Disconnected after %d games. %llu decisions, avg %.1f us, max %.1f us.\n",
+           games, (unsigned long long)decisions,
+           decisions ? (double)total_ns / (double)decisions / 1e3 : 0.0, (double)max_ns / 1e3);
+
+    if (ready) bot_free(&bot);
+    dict_close(&dict);
+    close(fd);
+    return 0;
+}
@@ -1,28 +1,119 @@
 // client.c - TCP client for the 3-player word guessing game
-// Build: gcc -O2 -Wall -Wextra -pedantic client.c -o client
+// Build: make client   (gcc ... client.c bot.o -o client -lm)
 //
 // Usage:
-//   ./client <server_ip> <port> <name>
+//   ./client [--latency=FILE] [--record=FILE] [--resume=TOKEN] [--binary] <server_ip> <port> <name>
+//   ./client --bot=info|freq|random [--think=MS] [--think-dist=fixed|uniform|exp]
+//            [--dict=dict.idx] <server_ip> <port> <name>
+//   ./client --load=N [--ports=K] [--think=MS] [--think-dist=...] [--strategy=random|sweep]
+//            [--duration=SEC] [--dict=dict.idx] [--binary] <server_ip> <port> <name>
+//   ./client --load=N --replay=FILE[,FILE...] [--speed=X|max] [--ports=K]
+//            [--duration=SEC] <server_ip> <port> <name>
 // Example:
 //   ./client 127.0.0.1 5000 Alice
+//   ./client --bot=info --think=800 --think-dist=exp 127.0.0.1 5000 Robo
+//   ./client --load=3000 --ports=1000 --think=50 127.0.0.1 6000 load
+//   ./client --load=300 --ports=100 --replay=wm.trc,a.trc,b.trc --speed=max 127.0.0.1 6000 rp
+//
+// Load-generator mode (--load) plays N sessions from one process with
+// epoll instead of one interactive session: session i connects to port
+// + i % K (each server hosts one room, so start K servers on consecutive
+// ports and use N = 3K, or 2K for --auto rooms). Sessions answer every
+// prompt themselves, wordmaster and guesser alike, after a think time of
+// MS +-50%. Guess strategies: random (an untried letter for the position)
+// or sweep (untried letters in English frequency order); word-rule rooms
+// get random dictionary words. At exit (SIGINT, --duration or every
+// session closed) it prints connects/s, games/s and the latency report of
+// all sessions together.
+//
+// Bot mode (--bot) is one ordinary session whose prompts are answered by a
+// bot.h strategy instead of stdin (see the Bot player section). Both modes
+// wait --think=MS on average before each answer; --think-dist shapes the
+// delay: fixed, uniform over MS +-50% (default) or exponential (capped at
+// 10x MS), which gives the mostly-quick, sometimes-slow pace of people.
+//
+// Every mode measures the latency players feel (see Latency probe) and
+// reports it at exit and on SIGUSR1 (kill -USR1 <pid>); --latency=FILE
+// appends the reports to FILE.
+//
+// --record=FILE (interactive or --bot) writes every line the session sends
+// and receives, with monotonic timestamps, to a trace (trace.h). --replay
+// turns --load sessions into replayers of such traces: each session takes
+// a trace recorded in the same seat (ROLE line) and sends its lines after
+// the same prompts, with the recorded think time divided by --speed (max:
+// no wait). Record the three seats of a room, then replay them across many
+// rooms for a reproducible throughput benchmark.
+//
+// --binary (any mode) asks the server for wire.h frames instead of text
+// lines; --load then also reports bytes received and client CPU per game,
+// to compare with a text run.
 
+#define _GNU_SOURCE
 #include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <math.h>
 #include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 #include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "bot.h"
+#include "dict.h"
+#include "hist.h"
+#include "proto.h"
+#include "trace.h"
+#include "wire.h"
+
+#define MAX_WORD_LEN 12   // longest room word length the server supports
+
+// CLOCK_MONOTONIC nanoseconds; every timer in the client reads this one clock
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
 static int game_active = 0;
 
+// ---------- Traffic recorder (--record) ----------
+static FILE *trc_out = NULL;
+static uint64_t trc_last_ns = 0;
+
+static int trace_start(const char *path) {
+    trc_out = fopen(path, "wb");
+    if (!trc_out) return -1;
+    trace_header_t h = { TRACE_MAGIC, 0, (uint64_t)time(NULL) };
+    fwrite(&h, sizeof(h), 1, trc_out);
+    trc_last_ns = now_ns();
+    return 0;
+}
+
+static void trace_record(int dir, const char *line) {
+    uint8_t rec[TRACE_MAX_LINE + 20];
+    uint64_t now = now_ns();
+    size_t n = trace_encode(rec, (now - trc_last_ns) / 1000, dir, line, strlen(line));
+    trc_last_ns += (now - trc_last_ns) / 1000 * 1000;   // keep sub-us remainders
+    fwrite(rec, 1, n, trc_out);
+    if (dir == TRACE_SENT) fflush(trc_out);
+}
+
 static ssize_t send_all(int fd, const void *buf, size_t len) {
     const char *p = (const char*)buf;
     size_t off = 0;
     while (off < len) {
-        ssize_t w = send(fd, p + off, len - off, 0);
+        ssize_t w = send(fd, p + off, len - off, MSG_NOSIGNAL);   // a dropped server is an error, not SIGPIPE
         if (w < 0) {
             if (errno == EINTR) continue;
             return -1;
@@ -34,6 +125,7 @@ static ssize_t send_all(int fd, const void *buf, size_t len) {
 }
 
 static int send_line(int fd, const char *line) {
+    if (trc_out) trace_record(TRACE_SENT, line);
     char buf[512];
     snprintf(buf, sizeof(buf), "%s\n", line);
     return (send_all(fd, buf, strlen(buf)) < 0) ? -1 : 0;
@@ -71,297 +163,1654 @@ static int connect_to(const char *ip, uint16_t port) {
         exit(1);
     }
     if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
-        perror("connect");
-        exit(1);
+        close(fd);
+        return -1;
     }
     return fd;
 }
 
+// ---------- Think time (--bot, --load) ----------
+enum { THINK_FIXED, THINK_UNIFORM, THINK_EXP };
+
+static uint64_t xorshift64(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return *s = x;
+}
+
+static int think_dist_parse(const char *name) {
+    if (strcmp(name, "fixed") == 0) return THINK_FIXED;
+    if (strcmp(name, "uniform") == 0) return THINK_UNIFORM;
+    if (strcmp(name, "exp") == 0) return THINK_EXP;
+    return -1;
+}
+
+static uint64_t think_sample_ns(uint64_t mean_ns, int dist, uint64_t *rng) {
+    if (mean_ns == 0 || dist == THINK_FIXED) return mean_ns;
+    uint64_t r = xorshift64(rng);
+    if (dist == THINK_UNIFORM) return mean_ns / 2 + r % (mean_ns + 1);
+    double u = ((double)(r >> 11) + 1.0) / 9007199254740992.0;     // (0, 1]
+    double t = -log(u) * (double)mean_ns;
+    return (uint64_t)(t < 10.0 * (double)mean_ns ? t : 10.0 * (double)mean_ns);
+}
+
 // --- UI state ---
 static int my_player_id = 0;   // 0 = wordmaster, 1/2 = guesser
 static int current_pass = 1;   // 1..5
 static int current_turn = 0;   // 0/1/2
-static int cursor_pos0  = 0;   // 0..4
-static char row[6] = "_____";  // feedback row for current pass
+static int cursor_pos0  = 0;   // 0..word_len-1
+static int word_len     = 5;   // from "len=" on the ROLE line
+static int word_rules   = 0;   // "rules=word" on the ROLE line: whole-word guesses
+static char row[MAX_WORD_LEN + 1] = "_____";  // feedback row for current pass
 
 static void reset_row(void) {
-    for (int i = 0; i < 5; i++) row[i] = '_';
-    row[5] = '\0';
+    for (int i = 0; i < word_len; i++) row[i] = '_';
+    row[word_len] = '\0';
 }
 
-static void render_screen(int pass, int pos0) {
-    // Always redraw from the top cleanly
-    // 1) go home
-    // 2) clear from cursor to end (removes leftover blocks below)
-    printf("\033[H\033[J");
+static void parse_word_len(const char *line) {
+    proto_line_t f;
+    proto_parse(line, &f);
+    if (!proto_has(&f, PROTO_LEN)) return;
+    int n = f.f[PROTO_LEN].num;
+    if (n >= 1 && n <= MAX_WORD_LEN) word_len = n;
+    word_rules = proto_eq(&f, PROTO_RULES, "word");
+}
+
+// ---------- Screen renderer ----------
+// render_screen() composes the whole view into scr_next; screen_flush()
+// compares it with the frame last written (scr_shown) and sends only the
+// cells that changed, each run after one cursor move, as a single write().
+// Server messages, the input prompt and the line being typed live inside
+// the frame too (the terminal does not echo), so nothing else scrolls the
+// terminal under it. Frames are rate limited in
+// main(): a burst of STATE lines becomes one frame per SCREEN_REFRESH_MS.
+#define SCREEN_ROWS 16
+#define SCREEN_COLS 80
+#define SCREEN_MSG_LINES 4          // newest server messages shown
+#define SCREEN_REFRESH_MS 33
+#define SCREEN_PROMPT_ROW (SCREEN_ROWS - 1)
+
+static char scr_next[SCREEN_ROWS][SCREEN_COLS];
+static char scr_shown[SCREEN_ROWS][SCREEN_COLS];
+static int scr_valid = 0;           // scr_shown matches the terminal
+static int scr_pending = 0;         // scr_next not written yet
+static uint64_t scr_last_ms = 0;
+static char scr_msgs[SCREEN_MSG_LINES][SCREEN_COLS];
+static int scr_nmsgs = 0;
+static char scr_prompt[SCREEN_COLS] = "";
+static char scr_input[SCREEN_COLS] = "";   // line editor buffer, drawn after the prompt
+static int scr_input_len = 0;
+
+static void screen_put(int r, const char *fmt, ...) {
+    char tmp[SCREEN_COLS + 1];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, ap);
+    va_end(ap);
+    if (n < 0) n = 0;
+    if (n > SCREEN_COLS) n = SCREEN_COLS;
+    memcpy(scr_next[r], tmp, (size_t)n);
+    memset(scr_next[r] + n, ' ', (size_t)(SCREEN_COLS - n));
+}
+
+// Server text shown in the frame's message area (oldest scrolls out)
+static void screen_message(const char *line) {
+    if (scr_nmsgs == SCREEN_MSG_LINES) {
+        memmove(scr_msgs[0], scr_msgs[1], sizeof(scr_msgs[0]) * (SCREEN_MSG_LINES - 1));
+        scr_nmsgs--;
+    }
+    snprintf(scr_msgs[scr_nmsgs++], SCREEN_COLS, "%.*s", SCREEN_COLS - 1, line);
+}
+
+// The line was submitted: drop the prompt and the typed text next frame
+static void screen_input_done(void) {
+    scr_prompt[0] = '\0';
+    scr_input[0] = '\0';
+    scr_input_len = 0;
+}
+
+static void screen_flush(void) {
+    static char out[SCREEN_ROWS * (SCREEN_COLS + 16) + 64];
+    size_t n = 0;
+    if (!scr_valid) {
+        n += (size_t)snprintf(out + n, sizeof(out) - n, "\033[H\033[J");
+        memset(scr_shown, ' ', sizeof(scr_shown));
+    }
+    for (int r = 0; r < SCREEN_ROWS; r++) {
+        int c = 0;
+        while (c < SCREEN_COLS) {
+            if (scr_next[r][c] == scr_shown[r][c]) { c++; continue; }
+            // A run of changes; gaps of a few equal cells are cheaper to resend than a new move
+            int end = c + 1, same = 0;
+            for (int k = c + 1; k < SCREEN_COLS && same < 6; k++) {
+                if (scr_next[r][k] == scr_shown[r][k]) same++;
+                else { same = 0; end = k + 1; }
+            }
+            n += (size_t)snprintf(out + n, sizeof(out) - n, "\033[%d;%dH", r + 1, c + 1);
+            memcpy(out + n, &scr_next[r][c], (size_t)(end - c));
+            n += (size_t)(end - c);
+            c = end;
+        }
+    }
+    // Leave the cursor after the typed input (or below the frame)
+    static int last_pcol = 0;
+    int pcol = scr_prompt[0] ? (int)strlen(scr_prompt) + scr_input_len + 1 : 1;
+    if (pcol > SCREEN_COLS) pcol = SCREEN_COLS;
+    if (n > 0 || pcol != last_pcol) {
+        n += (size_t)snprintf(out + n, sizeof(out) - n, "\033[%d;%dH", SCREEN_PROMPT_ROW + 1, pcol);
+    }
+    last_pcol = pcol;
+
+    fflush(stdout);
+    for (size_t off = 0; off < n; ) {
+        ssize_t w = write(STDOUT_FILENO, out + off, n - off);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        off += (size_t)w;
+    }
+    memcpy(scr_shown, scr_next, sizeof(scr_shown));
+    scr_valid = 1;
+    scr_pending = 0;
+    scr_last_ms = now_ns() / 1000000ull;
+}
 
-    // If you still want one-time full clear on "new game start", keep this:
-    // (optional) but NOT necessary if you use H+J every time
+static void render_screen(int pass, int pos0) {
     if (!game_active) {
         game_active = 1;
     }
 
-    // Helper macro: print line + clear to end of line
-    // \033[K clears from cursor to end-of-line, prevents trailing ghosts
-    #define PRINT_LINE(fmt, ...) do { \
-        printf(fmt, ##__VA_ARGS__);   \
-        printf("\033[K\n");           \
-    } while (0)
-
-    PRINT_LINE("               Round %d", pass);
-    PRINT_LINE("");
+    int r = 0;
+    screen_put(r++, "               Round %d", pass);
+    screen_put(r++, "");
 
-    if (my_player_id == 0) PRINT_LINE("----------Wordmaster view----------");
-    else PRINT_LINE("----------Player%d view----------", my_player_id);
+    if (my_player_id == 0) screen_put(r++, "----------Wordmaster view----------");
+    else screen_put(r++, "----------Player%d view----------", my_player_id);
 
-    PRINT_LINE("");
+    screen_put(r++, "");
 
     if (current_turn == 1 || current_turn == 2) {
-        if (my_player_id == current_turn) PRINT_LINE("Turn: player%d (YOU)", current_turn);
-        else PRINT_LINE("Turn: player%d", current_turn);
+        if (my_player_id == current_turn) screen_put(r++, "Turn: player%d (YOU)", current_turn);
+        else screen_put(r++, "Turn: player%d", current_turn);
     } else {
-        PRINT_LINE("Turn: -");
+        screen_put(r++, "Turn: -");
     }
 
-    PRINT_LINE("");
+    screen_put(r++, "");
 
     // Row line
-    printf("               ");
-    for (int i = 0; i < 5; i++) {
-        char c = row[i] ? row[i] : '_';
-        printf("%c", c);
-        if (i != 4) printf(" ");
+    char cells[2 * MAX_WORD_LEN + 1];
+    int k = 0;
+    for (int i = 0; i < word_len; i++) {
+        cells[k++] = row[i] ? row[i] : '_';
+        if (i != word_len - 1) cells[k++] = ' ';
     }
-    printf("\033[K\n"); // clear rest of that line
+    cells[k] = '\0';
+    screen_put(r++, "               %s", cells);
 
-    // Caret line
+    // Caret line (word rules guess every position at once: no caret)
     if (pos0 < 0) pos0 = 0;
-    if (pos0 > 4) pos0 = 4;
-    int caret_offset = pos0 * 2;
+    if (pos0 > word_len - 1) pos0 = word_len - 1;
+    if (word_rules) screen_put(r++, "");
+    else screen_put(r++, "               %*s^", pos0 * 2, "");
 
-    printf("               ");
-    for (int i = 0; i < caret_offset; i++) printf(" ");
-    printf("^\033[K\n");
+    screen_put(r++, "");
 
-    PRINT_LINE("");
+    while (r < SCREEN_PROMPT_ROW - SCREEN_MSG_LINES) screen_put(r++, "");
+    for (int i = 0; i < SCREEN_MSG_LINES; i++) screen_put(r++, "%s", i < scr_nmsgs ? scr_msgs[i] : "");
+    screen_put(r, "%s%s", scr_prompt, scr_prompt[0] ? scr_input : "");
 
-    fflush(stdout);
+    scr_pending = 1;
+}
+
+// ---------- Latency probe ----------
+// Two waits, timed from the client's side of the socket into hist.h
+// histograms:
+//   GUESS->STATE      sending GUESS/GUESSWORD until the STATE for it arrives
+//   STATE->YOUR_TURN  the last STATE before our YOUR_TURN until the prompt
+//                     arrives: the server's turn handoff, scheduler included
+// Lines are stamped when their read() returns, not when they are handled.
+// The report (p50/p90/p99/max) goes to stdout at exit; on SIGUSR1 a
+// session shows it in the message area (stdout is the screen) and --load
+// prints it. With --latency=FILE every report is appended there instead.
+static hist_t lat_guess, lat_turn;
+static volatile sig_atomic_t lat_report_req = 0;
+static const char *lat_path = NULL;
+static uint64_t lat_rx_ns = 0;      // arrival of the lines being handled
+static uint64_t lat_sent_ns = 0;    // our guess awaiting its STATE, 0 if none
+static uint64_t lat_state_ns = 0;   // last STATE since our last YOUR_TURN, 0 if none
 
-    #undef PRINT_LINE
+static void lat_sigusr1(int sig) {
+    (void)sig;
+    lat_report_req = 1;
 }
 
-static void handle_state_line(const char *line) {
-    // STATE from=1 pass=1/5 pos=2 guess=A result=PRESENT display=_A___ scoreA=0 scoreB=0 next_pass=1/5 next_pos=3 turn=2
-    int pass=1, pos=1, next_pass=1, next_pos=1, turn=0;
-    char guess='?';
-    char result[16] = "";
-    const char *p;
-    char disp[6] = "_____";
-
-    p = strstr(line, "result=");
-    if (p) {
-        p += 7;
-        int i = 0;
-        while (p[i] && p[i] != ' ' && i < 15) {
-            result[i] = p[i];
-            i++;
-        }
-        result[i] = '\0';
-    }
+static void lat_install(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = lat_sigusr1;
+    sigaction(SIGUSR1, &sa, NULL);
+}
 
-    p = strstr(line, "display=");
-    if (p) {
-        p += 8; // skip "display="
-        int i = 0;
-        while (p[i] && p[i] != ' ' && i < 5) {
-            disp[i] = p[i];
-            i++;
-        }
-        for (; i < 5; i++) disp[i] = '_';
-        disp[5] = '\0';
+// why: "exit" or "SIGUSR1"; to_screen: a session's SIGUSR1 report
+static void lat_report(const char *why, int to_screen) {
+    char guess[160], turn[160];
+    hist_format(guess, sizeof(guess), "GUESS->STATE", &lat_guess);
+    hist_format(turn, sizeof(turn), "STATE->YOUR_TURN", &lat_turn);
+    if (lat_path) {
+        FILE *f = fopen(lat_path, "a");
+        if (!f) return;
+        char ts[32];
+        time_t t = time(NULL);
+        strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", localtime(&t));
+        fprintf(f, "# %s pid %d (%s)\n%s\n%s\n", ts, (int)getpid(), why, guess, turn);
+        fclose(f);
+    } else if (to_screen) {
+        screen_message(guess);
+        screen_message(turn);
+    } else {
+        printf("%s\n%s\n", guess, turn);
+        fflush(stdout);
     }
+}
+
+static void lat_on_sent(void) {
+    lat_sent_ns = now_ns();
+}
 
-    p = strstr(line, "pass=");
-    if (p) pass = atoi(p + 5);
+static void lat_on_state(int from) {
+    if (lat_sent_ns && from == my_player_id) {
+        hist_record(&lat_guess, lat_rx_ns - lat_sent_ns);
+        lat_sent_ns = 0;
+    }
+    lat_state_ns = lat_rx_ns;
+}
 
-    p = strstr(line, "pos=");
-    if (p) pos = atoi(p + 4);
+static void lat_on_turn(void) {
+    if (lat_state_ns) hist_record(&lat_turn, lat_rx_ns - lat_state_ns);
+    lat_state_ns = 0;
+}
 
-    p = strstr(line, "guess=");
-    if (p) guess = p[6];
+// ---------- Bot player (--bot) ----------
+// The session runs through the same line handlers as the UI. Every
+// letter-rule STATE handle_state_line() decodes is also fed to a bot.h
+// guesser (random, freq, or info: the dictionary-filtering one), and when
+// a prompt opens main() schedules an answer after a think time; the answer
+// is put in the input line and submitted as if typed. The wordmaster slot
+// and word-rule rooms get a random dictionary word. stdin is not read.
+static int cbot_on = 0;
+static bot_strategy_t cbot_strategy = BOT_INFO;
+static dict_t cbot_dict;
+static bot_t cbot;
+static int cbot_len = 0;            // word length cbot was built for, 0 if none
+static uint64_t cbot_rng = 1;
+static uint64_t cbot_think_ns = 0;
+static int cbot_think_dist = THINK_UNIFORM;
 
-    p = strstr(line, "result=");
-    if (p) {
-        p += 7;
-        int i = 0;
-        while (p[i] && p[i] != ' ' && i < 15) { result[i] = p[i]; i++; }
-        result[i] = '\0';
+// After a ROLE line: a fresh game, rebuilding the word list if len changed
+static void cbot_role(void) {
+    if (!cbot_on) return;
+    if (cbot_len == word_len) {
+        bot_new_game(&cbot);
+        return;
     }
+    if (cbot_len) bot_free(&cbot);
+    cbot_len = 0;
+    if (bot_init(&cbot, &cbot_dict, word_len, xorshift64(&cbot_rng)) != 0) {
+        fprintf(stderr, "No %d-letter words in the --dict index.\n", word_len);
+        exit(1);
+    }
+    cbot.strategy = cbot_strategy;
+    cbot_len = word_len;
+}
 
-    p = strstr(line, "next_pass=");
-    if (p) next_pass = atoi(p + 10);
+static void cbot_observe(int pos0, char letter, engine_result_t r) {
+    if (cbot_len) bot_observe(&cbot, pos0, letter, r);
+}
 
-    p = strstr(line, "next_pos=");
-    if (p) next_pos = atoi(p + 9);
+static void cbot_new_game(void) {
+    if (cbot_len) bot_new_game(&cbot);
+}
 
-    p = strstr(line, "turn=");
-    if (p) turn = atoi(p + 5);
+// Types the answer to the open prompt into scr_input
+static void cbot_answer(int wordmaster) {
+    if (!cbot_len) return;
+    char w[ENGINE_MAX_WORD_LEN + 1];
+    if (wordmaster || word_rules) bot_random_word(&cbot, w);
+    if (wordmaster) snprintf(scr_input, sizeof(scr_input), "WORD %s", w);
+    else if (word_rules) snprintf(scr_input, sizeof(scr_input), "%s", w);
+    else snprintf(scr_input, sizeof(scr_input), "%c", bot_choose(&cbot, cursor_pos0));
+    scr_input_len = (int)strlen(scr_input);
+}
+
+// STATE lines and frames both land here (wire.h's decoded form). Word
+// rules: the row shows the latest word: letter if CORRECT, '*' PRESENT,
+// '-' ABSENT
+static void apply_word_state(const wire_state_t *s) {
+    lat_on_state(s->from);
+    for (int i = 0; i < word_len && s->guessword[i] && s->feedback[i]; i++) {
+        row[i] = (s->feedback[i] == 'C') ? s->guessword[i] : (s->feedback[i] == 'P') ? '*' : '-';
+    }
+    current_pass = s->next_pass;
+    current_turn = s->turn;
 
-    // NEW GAME START: server reset display to _____ at pass 1
-    if (pass == 1 && pos == 1 && strcmp(disp, "_____") == 0) {
+    render_screen(current_pass, 0);
+}
+
+// result: engine_result_t, or -1 if the line had none the client knows
+static void apply_state(const wire_state_t *s) {
+    lat_on_state(s->from);
+
+    // NEW GAME START: server reset display to all '_' at pass 1
+    int blank = 1;
+    for (int i = 0; i < word_len && s->display[i]; i++) if (s->display[i] != '_') blank = 0;
+    if (s->pass == 1 && s->pos == 1 && blank) {
         current_pass = 1;
         reset_row();    // <-- THIS resets the screen to _ _ _ _ _
     }
 
     // If pass advanced, reset feedback row
-    if (next_pass != current_pass) {
-        current_pass = next_pass;
+    if (s->next_pass != current_pass) {
+        current_pass = s->next_pass;
         reset_row();
-    } else if (pass != current_pass) {
-        current_pass = next_pass;
+    } else if (s->pass != current_pass) {
+        current_pass = s->next_pass;
         reset_row();
     }
 
     // Update feedback at the position that was just guessed
-    int idx = pos - 1;
-    if (idx >= 0 && idx < 5) {
-        char up = guess;
+    int idx = s->pos - 1;
+    if (idx >= 0 && idx < word_len) {
+        char up = s->letter;
         if (up >= 'a' && up <= 'z') up = (char)(up - 'a' + 'A');
-        if (strcmp(result, "CORRECT") == 0) row[idx] = up;
-        else if (strcmp(result, "PRESENT") == 0) row[idx] = '*';
-        else if (strcmp(result, "ABSENT") == 0) row[idx] = '-';
-        else row[idx] = '_';
+        int res = s->result;
+        row[idx] = (res == ENGINE_CORRECT) ? up : (res == ENGINE_PRESENT) ? '*' : (res == ENGINE_ABSENT) ? '-' : '_';
+        if (res >= 0) cbot_observe(idx, up, (engine_result_t)res);
     }
 
-    current_turn = turn;
-    cursor_pos0 = (next_pos > 0) ? (next_pos - 1) : 0;
+    current_turn = s->turn;
+    cursor_pos0 = (s->next_pos > 0) ? (s->next_pos - 1) : 0;
 
     render_screen(current_pass, cursor_pos0);
 }
 
-int main(int argc, char **argv) {
-    if (argc != 4) {
-        fprintf(stderr, "Usage: %s <server_ip> <port> <name>\n", argv[0]);
-        return 1;
+static void proto_copy(const proto_line_t *f, int k, char *out, size_t cap) {
+    int n = proto_has(f, k) ? f->f[k].len : 0;
+    if ((size_t)n >= cap) n = (int)cap - 1;
+    if (n > 0) memcpy(out, f->f[k].p, (size_t)n);
+    out[n] = '\0';
+}
+
+static void handle_word_state_line(const char *line) {
+    // STATE from=1 pass=1/5 guessword=CRANE feedback=APCAA display=__A__ scoreA=1 scoreB=0 next_pass=1/5 turn=2
+    proto_line_t f;
+    proto_parse(line, &f);
+    wire_state_t s = { .word_rules = 1 };
+    s.from = proto_int(&f, PROTO_FROM, -1);
+    proto_copy(&f, PROTO_GUESSWORD, s.guessword, sizeof(s.guessword));
+    proto_copy(&f, PROTO_FEEDBACK, s.feedback, sizeof(s.feedback));
+    s.next_pass = proto_int(&f, PROTO_NEXT_PASS, current_pass);
+    s.turn = proto_int(&f, PROTO_TURN, 0);
+    apply_word_state(&s);
+}
+
+static void handle_state_line(const char *line) {
+    // STATE from=1 pass=1/5 pos=2 guess=A result=PRESENT display=_A___ scoreA=0 scoreB=0 next_pass=1/5 next_pos=3 turn=2
+    proto_line_t f;
+    proto_parse(line, &f);
+    wire_state_t s = { .word_rules = 0 };
+    s.from = proto_int(&f, PROTO_FROM, -1);
+    s.pass = proto_int(&f, PROTO_PASS, 1);
+    s.pos = proto_int(&f, PROTO_POS, 1);
+    s.next_pass = proto_int(&f, PROTO_NEXT_PASS, 1);
+    s.next_pos = proto_int(&f, PROTO_NEXT_POS, 1);
+    s.turn = proto_int(&f, PROTO_TURN, 0);
+    s.letter = proto_has(&f, PROTO_GUESS) ? f.f[PROTO_GUESS].p[0] : '?';
+    s.result = proto_eq(&f, PROTO_RESULT, "CORRECT") ? ENGINE_CORRECT
+             : proto_eq(&f, PROTO_RESULT, "PRESENT") ? ENGINE_PRESENT
+             : proto_eq(&f, PROTO_RESULT, "ABSENT") ? ENGINE_ABSENT : -1;
+    proto_copy(&f, PROTO_DISPLAY, s.display, sizeof(s.display));
+    apply_state(&s);
+}
+
+// ---------- Line editor ----------
+// main() polls stdin and the socket together, so server updates keep being
+// read and drawn while a guess is half typed. On a terminal, canonical mode
+// and echo are switched off and keys edit scr_input, which the renderer
+// draws after the prompt (Backspace, Ctrl-U, Ctrl-W; other control keys and
+// escape sequences are ignored). stdin is only read while a prompt is open;
+// keys typed earlier wait in the kernel, and piped input still answers one
+// prompt per line.
+#define INPUT_MAX 63
+
+enum { INPUT_NONE, INPUT_WORD, INPUT_GUESS };
+
+static int in_mode = INPUT_NONE;        // prompt waiting for a line
+static int in_retry = INPUT_NONE;       // prompt last answered, until the server accepts it
+static char in_retry_prompt[SCREEN_COLS];
+static char in_raw[256];                // read from stdin, not yet consumed
+static int in_raw_len = 0;
+static int in_eof = 0;
+static int in_esc = 0;                  // 1 after ESC, 2 inside ESC [ / ESC O
+static int in_tty = 0;
+static struct termios in_saved;
+
+static void input_restore(void) {
+    if (in_tty) tcsetattr(STDIN_FILENO, TCSAFLUSH, &in_saved);
+}
+
+static void input_signal(int sig) {
+    input_restore();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void input_init(void) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &in_saved) != 0) return;
+    struct termios t = in_saved;
+    t.c_lflag &= ~(tcflag_t)(ICANON | ECHO);
+    t.c_cc[VMIN] = 1;
+    t.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &t) != 0) return;
+    in_tty = 1;
+    atexit(input_restore);
+    signal(SIGINT, input_signal);
+    signal(SIGTERM, input_signal);
+    signal(SIGHUP, input_signal);
+}
+
+static void input_prompt(int mode, const char *prompt) {
+    in_mode = mode;
+    in_retry = INPUT_NONE;
+    snprintf(scr_prompt, sizeof(scr_prompt), "%s", prompt);
+}
+
+// Applies one key to scr_input; returns 1 when it completes the line
+static int input_key(unsigned char c) {
+    if (in_esc == 1) {
+        in_esc = (c == '[' || c == 'O') ? 2 : 0;
+        return 0;
+    }
+    if (in_esc == 2) {
+        if (c >= 0x40 && c <= 0x7e) in_esc = 0;    // final byte of the sequence
+        return 0;
+    }
+    if (c == '\n' || c == '\r') return 1;
+    if (c == 27) {
+        in_esc = 1;
+    } else if (c == 127 || c == 8) {
+        if (scr_input_len > 0) scr_input[--scr_input_len] = '\0';
+    } else if (c == 21) {                           // Ctrl-U
+        scr_input_len = 0;
+        scr_input[0] = '\0';
+    } else if (c == 23) {                           // Ctrl-W
+        while (scr_input_len > 0 && scr_input[scr_input_len - 1] == ' ') scr_input_len--;
+        while (scr_input_len > 0 && scr_input[scr_input_len - 1] != ' ') scr_input_len--;
+        scr_input[scr_input_len] = '\0';
+    } else if (c == 4) {                            // Ctrl-D on an empty line: EOF
+        if (scr_input_len == 0) in_eof = 1;
+    } else if (c >= 32 && c < 127 && scr_input_len < INPUT_MAX) {
+        scr_input[scr_input_len++] = (char)c;
+        scr_input[scr_input_len] = '\0';
+    }
+    return 0;
+}
+
+static void input_submit(int fd, int mode, const char *text) {
+    if (mode == INPUT_WORD) {
+        send_line(fd, text);
+        return;
     }
+    lat_on_sent();
+    if (word_rules) {
+        // Bare words are sent as GUESSWORD; the server validates them
+        char out[96];
+        if ((int)strlen(text) == word_len && strchr(text, ' ') == NULL) {
+            snprintf(out, sizeof(out), "GUESSWORD %s", text);
+            send_line(fd, out);
+        } else {
+            send_line(fd, text);
+        }
+    } else if (strlen(text) == 1 &&
+        ((text[0] >= 'A' && text[0] <= 'Z') || (text[0] >= 'a' && text[0] <= 'z'))) {
+        char out[64];
+        snprintf(out, sizeof(out), "GUESS %c", text[0]);
+        send_line(fd, out);
+    } else {
+        send_line(fd, text);
+    }
+}
 
-    const char *ip = argv[1];
-    uint16_t port = (uint16_t)atoi(argv[2]);
-    const char *name = argv[3];
+// Sends the line in scr_input and closes the prompt
+static void input_finish(int fd) {
+    char text[SCREEN_COLS];
+    snprintf(text, sizeof(text), "%s", scr_input);
+    in_retry = in_mode;
+    snprintf(in_retry_prompt, sizeof(in_retry_prompt), "%s", scr_prompt);
+    in_mode = INPUT_NONE;
+    screen_input_done();
+    input_submit(fd, in_retry, text);
+}
 
-    int fd = connect_to(ip, port);
+// Feeds buffered stdin bytes to the open prompt, stopping after one line;
+// returns 1 if the prompt row changed
+static int input_consume(int fd) {
+    int changed = 0, i = 0;
+    while (in_mode != INPUT_NONE && i < in_raw_len) {
+        changed = 1;
+        if (input_key((unsigned char)in_raw[i++])) input_finish(fd);
+    }
+    in_raw_len -= i;
+    memmove(in_raw, in_raw + i, (size_t)in_raw_len);
+    if (changed) render_screen(current_pass, cursor_pos0);
+    return changed;
+}
 
-    char line[512];
-    if (recv_line(fd, line, sizeof(line)) <= 0) {
-        fprintf(stderr, "Server closed.\n");
-        close(fd);
-        return 1;
+// ---------- Session resume ----------
+// The server answers NAME with SESSION token=... grace=SEC and holds our
+// slot that long after the connection drops. main() then reconnects and
+// sends RESUME <token> instead of NAME; the server answers SESSION, ROLE
+// and one RESUMED line (display, scores, pass, position, turn) in place of
+// the broadcasts we missed, and prompts again if it is our turn.
+// --resume=TOKEN resumes from a new process (e.g. after a crash).
+#define SESSION_RETRY_MS 500
+
+static char sess_token[24] = "";
+static int sess_grace_s = 0;
+static int wire_want = 0;               // --binary: ask for wire.h frames
+static int wire_on = 0;                 // the server agreed: it sends frames
+
+static void handle_session_line(const char *line) {
+    char tok[sizeof(sess_token)];
+    int grace = 0;
+    if (sscanf(line, "SESSION token=%23s grace=%d", tok, &grace) < 1) return;
+    snprintf(sess_token, sizeof(sess_token), "%s", tok);
+    sess_grace_s = grace;
+}
+
+// RESUMED pass=2/5 pos=3 display=_A___ scoreA=1 scoreB=0 turn=1
+static void handle_resumed_line(const char *line) {
+    proto_line_t f;
+    proto_parse(line, &f);
+    current_pass = proto_int(&f, PROTO_PASS, 1);
+    cursor_pos0 = proto_int(&f, PROTO_POS, 1) - 1;
+    if (cursor_pos0 < 0 || cursor_pos0 >= word_len) cursor_pos0 = 0;
+    current_turn = proto_int(&f, PROTO_TURN, 0);
+
+    // This pass's feedback was lost with the connection: show the letters
+    // revealed so far, which the bot can still use
+    reset_row();
+    if (proto_has(&f, PROTO_DISPLAY)) {
+        const proto_val_t *d = &f.f[PROTO_DISPLAY];
+        for (int i = 0; i < word_len && i < d->len; i++) {
+            if (d->p[i] < 'A' || d->p[i] > 'Z') continue;
+            row[i] = d->p[i];
+            if (!word_rules) cbot_observe(i, d->p[i], ENGINE_CORRECT);
+        }
     }
-    printf("%s\n", line);
+    screen_message(line);
+    render_screen(current_pass, cursor_pos0);
+}
+
+// --binary, during the handshake: one frame, rendered as its text line
+static ssize_t recv_frame_line(int fd, char *out, size_t cap) {
+    uint8_t f[WIRE_MAX_FRAME];
+    if (recv(fd, f, 1, MSG_WAITALL) != 1 || f[0] == 0) return -1;
+    if (recv(fd, f + 1, f[0], MSG_WAITALL) != (ssize_t)f[0]) return -1;
+    if (wire_text(out, cap, f[1], f + 2, (size_t)f[0] - 1) != 0) return -1;
+    return (ssize_t)strlen(out);
+}
+
+// Reads WELCOME and identifies: NAME, or RESUME if we hold a token, with
+// WIRE_HELLO appended if we want frames and the server offers them.
+// Returns 0, -1 if the server closed, -2 if it refused the token.
+static int session_hello(int fd, const char *name, int first) {
+    char line[512];
+    if (recv_line(fd, line, sizeof(line)) <= 0) return -1;
+    if (trc_out) trace_record(TRACE_RECV, line);
+    if (first) printf("%s\n", line);
+    wire_on = wire_want && strstr(line, WIRE_HELLO + 1) != NULL;
+    const char *hello = wire_on ? WIRE_HELLO : "";
 
     char msg[128];
-    snprintf(msg, sizeof(msg), "NAME %s", name);
+    if (!sess_token[0]) {
+        snprintf(msg, sizeof(msg), "NAME %s%s", name, hello);
+        send_line(fd, msg);
+        return 0;
+    }
+    snprintf(msg, sizeof(msg), "RESUME %s%s", sess_token, hello);
     send_line(fd, msg);
+    if ((wire_on ? recv_frame_line(fd, line, sizeof(line)) : recv_line(fd, line, sizeof(line))) <= 0) return -1;
+    if (trc_out) trace_record(TRACE_RECV, line);
+    if (strncmp(line, "SESSION ", 8) != 0) {
+        if (first) printf("%s\n", line);
+        return -2;
+    }
+    handle_session_line(line);
+    return 0;
+}
 
-    while (1) {
-        ssize_t r = recv_line(fd, line, sizeof(line));
-        if (r <= 0) {
-            printf("Disconnected.\n");
-            break;
+// The connection dropped: close the prompt (the server asks again if the
+// turn is still ours) and forget a guess in flight
+static void session_lost(void) {
+    in_mode = in_retry = INPUT_NONE;
+    screen_input_done();
+    lat_sent_ns = lat_state_ns = 0;
+    screen_message("Connection lost; resuming session...");
+    render_screen(current_pass, cursor_pos0);
+    screen_flush();
+}
+
+// Retries until the server's grace period is over; the new socket, or -1
+static int session_reconnect(const char *ip, uint16_t port, const char *name) {
+    uint64_t deadline = now_ns() / 1000000ull + (uint64_t)sess_grace_s * 1000u;
+    while (now_ns() / 1000000ull < deadline) {
+        int fd = connect_to(ip, port);
+        int rc = fd >= 0 ? session_hello(fd, name, 0) : -1;
+        if (rc == 0) return fd;
+        if (fd >= 0) close(fd);
+        if (rc == -2) break;    // slot expired or taken: nothing to retry
+        usleep(SESSION_RETRY_MS * 1000);
+    }
+    return -1;
+}
+
+// ROLE (line or frame): my_player_id, word_len and word_rules are set
+static void apply_role(void) {
+    cbot_role();
+    reset_row();
+    current_pass = 1;
+    current_turn = 0;
+    cursor_pos0 = 0;
+    render_screen(current_pass, cursor_pos0);
+}
+
+static void apply_turn(int pass, int pos) {
+    current_pass = pass;
+    cursor_pos0 = (pos > 0) ? (pos - 1) : 0;
+    current_turn = my_player_id;
+    lat_on_turn();
+
+    input_prompt(INPUT_GUESS, word_rules ? "Input word: " : "Input letter: ");
+    render_screen(current_pass, cursor_pos0);
+}
+
+// One server line: update the UI state, open a prompt if one is asked for
+static void handle_line(const char *line) {
+    // STATE updates redraw everyone
+    if (strncmp(line, "STATE", 5) == 0) {
+        in_retry = INPUT_NONE;
+        if (word_rules) handle_word_state_line(line);
+        else handle_state_line(line);
+        return;
+    }
+
+    if (strncmp(line, "SESSION ", 8) == 0) {
+        handle_session_line(line);
+        screen_message(line);
+        render_screen(current_pass, cursor_pos0);
+        return;
+    }
+    if (strncmp(line, "RESUMED", 7) == 0) {
+        handle_resumed_line(line);
+        return;
+    }
+
+    // Role assignment
+    if (strncmp(line, "ROLE GUESSER", 11) == 0) {
+        my_player_id = atoi(line + 12);
+        parse_word_len(line);
+        apply_role();
+        return;
+    }
+    if (strncmp(line, "ROLE WORDMASTER", 15) == 0) {
+        my_player_id = 0;
+        parse_word_len(line);
+        apply_role();
+        return;
+    }
+
+    // Wordmaster prompt
+    if (strncmp(line, "ENTER_WORD", 10) == 0) {
+        screen_message(line);
+        char prompt[64];
+        snprintf(prompt, sizeof(prompt), "Input (WORD %.*s): ", word_len, "ABCDEFGHIJKL");
+        input_prompt(INPUT_WORD, prompt);
+        render_screen(current_pass, cursor_pos0);
+        return;
+    }
+
+    if (strncmp(line, "GAME_OVER", 9) == 0) {
+        screen_message("=== GAME OVER ===");
+        screen_message(line);
+        render_screen(current_pass, cursor_pos0);
+
+        game_active = 0;   // <-- THIS IS STEP 3
+        if (word_rules) reset_row();   // next game's first row starts blank
+        in_retry = INPUT_NONE;
+        lat_sent_ns = lat_state_ns = 0;
+        cbot_new_game();
+
+        return;
+    }
+
+    // Your turn prompt
+    if (strncmp(line, "YOUR_TURN", 8) == 0) {
+        proto_line_t f;
+        proto_parse(line, &f);
+        apply_turn(proto_int(&f, PROTO_PASS, current_pass), proto_int(&f, PROTO_POS, cursor_pos0 + 1));
+        return;
+    }
+
+    // A rejected answer (bad letter, word not in the server's dictionary):
+    // the server waits for another line without prompting again
+    if (strncmp(line, "ERR ", 4) == 0 && in_retry != INPUT_NONE && in_mode == INPUT_NONE &&
+        strstr(line, "Not your turn") == NULL) {
+        int mode = in_retry;
+        lat_sent_ns = 0;
+        screen_message(line);
+        input_prompt(mode, in_retry_prompt);
+        render_screen(current_pass, cursor_pos0);
+        return;
+    }
+    if (strncmp(line, "OK ", 3) == 0) in_retry = INPUT_NONE;
+
+    // Game over: print message (screen will already show last STATE)
+    // if (strncmp(line, "GAME_OVER", 9) == 0) {
+    //     printf("%s\n", line);
+    //     return;
+    // }
+
+    // Default: show other messages in the frame
+    screen_message(line);
+    render_screen(current_pass, cursor_pos0);
+}
+
+// --binary: one wire.h frame (type byte, payload). STATE, YOUR_TURN and
+// ROLE go straight to the apply_*() handlers with no text in between; the
+// rest are rendered as their text line, which is also what --record stores.
+static void handle_frame(const uint8_t *p, size_t n) {
+    if (n == 0) return;
+    int type = p[0];
+    int direct = type == WIRE_STATE || type == WIRE_STATE_WORD || type == WIRE_YOUR_TURN || type == WIRE_ROLE;
+    char line[WIRE_MAX_FRAME + 64];
+    if (trc_out || !direct) {
+        if (wire_text(line, sizeof(line), type, p + 1, n - 1) != 0) return;
+        if (trc_out) trace_record(TRACE_RECV, line);
+    }
+    switch (type) {
+    case WIRE_STATE:
+    case WIRE_STATE_WORD: {
+        wire_state_t st;
+        if (wire_get_state(type, p + 1, n - 1, &st) != 0) return;
+        in_retry = INPUT_NONE;
+        if (st.word_rules) apply_word_state(&st);
+        else apply_state(&st);
+        return;
+    }
+    case WIRE_YOUR_TURN: {
+        wire_turn_t t;
+        if (wire_get_turn(p + 1, n - 1, &t) == 0) apply_turn(t.pass, t.pos);
+        return;
+    }
+    case WIRE_ROLE: {
+        wire_role_t r;
+        if (wire_get_role(p + 1, n - 1, &r) != 0) return;
+        my_player_id = r.player;
+        if (r.len >= 1 && r.len <= MAX_WORD_LEN) {
+            word_len = r.len;
+            word_rules = r.word_rules;
         }
+        apply_role();
+        return;
+    }
+    default:
+        handle_line(line);
+    }
+}
 
-        // STATE updates redraw everyone
-        if (strncmp(line, "STATE", 5) == 0) {
-            handle_state_line(line);
-            continue;
+// ---------- Load generator (--load) ----------
+#define LOAD_RBUF 1024
+#define LOAD_WBUF 256
+#define LOAD_FREQ_ORDER "ETAOINSHRDLCUMWFGYPBVKJXQZ"
+
+enum { LOAD_CONNECTING, LOAD_OPEN, LOAD_CLOSED };
+enum { LOAD_ACT_NONE, LOAD_ACT_GUESS, LOAD_ACT_WORD, LOAD_ACT_REPLAY };
+
+// A trace, reduced to what its player sent after ROLE
+typedef struct {
+    int player;                         // seat from the trace's ROLE line
+    int nsends;
+    char **line;
+    int *prompt;                        // ENTER_WORD/YOUR_TURN lines received before each
+    uint64_t *gap_ns;                   // recorded wait after its anchor (replay_arm)
+    int games;                          // GAME_OVER lines in the trace
+} replay_trace_t;
+
+typedef struct {
+    int fd;
+    int state;                          // LOAD_*
+    int player;                         // -1 until ROLE
+    int len;
+    int word_rules;
+    int binary;                         // --binary and the server offered it: frames after WELCOME
+    int pos;                            // 0-based position of the last YOUR_TURN
+    uint32_t tried[MAX_WORD_LEN];       // letters anyone guessed at each position this game
+    int action;                         // LOAD_ACT_* due at due_ns
+    uint64_t due_ns;
+    uint64_t guess_sent_ns;             // 0 unless a guess awaits its STATE
+    uint64_t state_ns;                  // last STATE since our YOUR_TURN, 0 if none
+    uint64_t connect_start_ns;
+    const replay_trace_t *trace;        // --replay: bound at ROLE, NULL if none
+    int next;                           // next trace line to send
+    int prompts, games_seen;            // since ROLE
+    uint64_t prompt_ns, sent_ns;        // last prompt received / trace line sent
+    size_t rlen, wlen;
+    char rbuf[LOAD_RBUF];
+    char wbuf[LOAD_WBUF];
+} load_session_t;
+
+typedef struct {
+    int epfd;
+    load_session_t *s;
+    int n;
+    uint64_t think_ns;
+    int think_dist;                     // THINK_*
+    int sweep;                          // strategy: 1 sweep, 0 random
+    const char *name;
+    uint64_t *words;                    // dict_pack() keys of --dict, per length
+    size_t nwords[MAX_WORD_LEN + 1];
+    size_t word_off[MAX_WORD_LEN + 1];
+    uint64_t rng;
+
+    uint64_t connected, connect_failed, closed;
+    uint64_t t_first_connect, t_last_connect;
+    uint64_t games, guesses, words_sent, errors;
+    uint64_t rx_bytes;
+    int binary;                         // --binary
+
+    replay_trace_t *traces;             // --replay, else NULL
+    int ntraces;
+    int trace_rr;                       // round robin over traces of a seat
+    double speed;                       // think time divisor, 0: no waiting
+    uint64_t replayed, unmatched;
+} load_t;
+
+static volatile sig_atomic_t g_load_stop = 0;
+
+static void load_sigint(int sig) {
+    (void)sig;
+    g_load_stop = 1;
+}
+
+static uint64_t load_rand(load_t *L) {
+    return xorshift64(&L->rng);
+}
+
+typedef struct {
+    uint64_t *out;
+    size_t n;
+    int len;
+} load_collect_t;
+
+static void load_collect_word(const char *w, void *ctx) {
+    load_collect_t *c = (load_collect_t*)ctx;
+    int ok;
+    c->out[c->n++] = dict_pack(w, c->len, &ok);
+}
+
+// Every word of every length in path, grouped by length; no dict is fine
+static void load_dict(load_t *L, const char *path) {
+    dict_t d;
+    if (!path || dict_open(&d, path) != 0) return;
+    size_t total = 0;
+    for (int len = DICT_MIN_LEN; len <= MAX_WORD_LEN; len++) total += (size_t)dict_count(&d, len);
+    L->words = malloc((total ? total : 1) * sizeof(uint64_t));
+    if (L->words) {
+        size_t off = 0;
+        for (int len = DICT_MIN_LEN; len <= MAX_WORD_LEN; len++) {
+            load_collect_t c = { L->words + off, 0, len };
+            dict_foreach(&d, len, load_collect_word, &c);
+            L->word_off[len] = off;
+            L->nwords[len] = c.n;
+            off += c.n;
         }
+    }
+    dict_close(&d);
+}
+
+// A dictionary word of len letters, or random letters without one
+static void load_random_word(load_t *L, int len, char *out) {
+    if (L->nwords[len]) {
+        uint64_t v = L->words[L->word_off[len] + load_rand(L) % L->nwords[len]] - 1;
+        for (int k = 0; k < len; k++) out[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+    } else {
+        for (int k = 0; k < len; k++) out[k] = (char)('A' + load_rand(L) % 26);
+    }
+    out[len] = '\0';
+}
+
+static char load_pick_letter(load_t *L, load_session_t *s) {
+    uint32_t tried = s->tried[s->pos];
+    if (tried == (1u << 26) - 1) tried = 0;     // all 26 tried: start over
+    if (L->sweep) {
+        for (const char *c = LOAD_FREQ_ORDER; *c; c++) {
+            if (!((tried >> (*c - 'A')) & 1u)) return *c;
+        }
+    }
+    int left = 26 - __builtin_popcount(tried);
+    int k = (int)(load_rand(L) % (uint64_t)left);
+    for (int l = 0; l < 26; l++) {
+        if ((tried >> l) & 1u) continue;
+        if (k-- == 0) return (char)('A' + l);
+    }
+    return 'E';
+}
+
+static void load_close(load_t *L, load_session_t *s) {
+    if (s->state == LOAD_CLOSED) return;
+    epoll_ctl(L->epfd, EPOLL_CTL_DEL, s->fd, NULL);
+    close(s->fd);
+    s->state = LOAD_CLOSED;
+    s->action = LOAD_ACT_NONE;
+    L->closed++;
+}
+
+static void load_watch(load_t *L, load_session_t *s, uint32_t events) {
+    struct epoll_event ev = { .events = events, .data.u32 = (uint32_t)(s - L->s) };
+    epoll_ctl(L->epfd, EPOLL_CTL_MOD, s->fd, &ev);
+}
+
+static void load_flush(load_t *L, load_session_t *s) {
+    while (s->wlen) {
+        ssize_t w = send(s->fd, s->wbuf, s->wlen, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            load_watch(L, s, EPOLLIN | EPOLLOUT);
+            return;
+        }
+        if (w <= 0) { load_close(L, s); return; }
+        memmove(s->wbuf, s->wbuf + w, s->wlen - (size_t)w);
+        s->wlen -= (size_t)w;
+    }
+    load_watch(L, s, EPOLLIN);
+}
 
-        // Role assignment
-        if (strncmp(line, "ROLE GUESSER", 11) == 0) {
-            my_player_id = atoi(line + 12);
-            reset_row();
-            current_pass = 1;
-            current_turn = 0;
-            cursor_pos0 = 0;
-            render_screen(current_pass, cursor_pos0);
+static void load_send(load_t *L, load_session_t *s, const char *line) {
+    int n = snprintf(s->wbuf + s->wlen, LOAD_WBUF - s->wlen, "%s\n", line);
+    if (n < 0 || (size_t)n >= LOAD_WBUF - s->wlen) { load_close(L, s); return; }
+    s->wlen += (size_t)n;
+    load_flush(L, s);
+}
+
+static void load_schedule(load_t *L, load_session_t *s, int action, uint64_t now) {
+    uint64_t think = think_sample_ns(L->think_ns, L->think_dist, &L->rng);
+    s->action = action;
+    s->due_ns = now + think;
+}
+
+// ---------- Trace replay (--load --replay) ----------
+// A trace's sent lines are answers to prompts. Each one waits until the
+// session has received as many prompts as the recorded player had when
+// sending it, then for the recorded gap after its anchor: the later of that
+// prompt's arrival and the previous send. Replies drive the pace, so a
+// replay stays in step with the server at any --speed.
+
+static int replay_role_player(const char *line) {
+    return (strncmp(line, "ROLE GUESSER", 12) == 0) ? atoi(line + 12) : 0;
+}
+
+static int replay_load(const char *path, replay_trace_t *t) {
+    memset(t, 0, sizeof(*t));
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+    uint8_t *buf = NULL;
+    size_t len = 0, cap = 0, r;
+    do {
+        if (len == cap) {
+            cap = cap ? cap * 2 : 65536;
+            uint8_t *grown = realloc(buf, cap);
+            if (!grown) { free(buf); fclose(f); return -1; }
+            buf = grown;
+        }
+        r = fread(buf + len, 1, cap - len, f);
+        len += r;
+    } while (r > 0);
+    fclose(f);
+
+    trace_header_t h;
+    if (len < sizeof(h)) { free(buf); return -1; }
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != TRACE_MAGIC) { free(buf); return -1; }
+
+    const uint8_t *p = buf + sizeof(h), *end = buf + len;
+    int seated = 0, prompts = 0, cap_sends = 0, ok = 1;
+    uint64_t t_ns = 0, prompt_t = 0, sent_t = 0, dt;
+    int dir;
+    const char *line;
+    size_t n;
+    while (ok && (p = trace_decode(p, end, &dt, &dir, &line, &n))) {
+        t_ns += dt * 1000;
+        if (!seated) {
+            // Everything up to ROLE (WELCOME, NAME) is the replayer's own business
+            if (dir == TRACE_RECV && n > 5 && strncmp(line, "ROLE ", 5) == 0) {
+                char l[TRACE_MAX_LINE + 1];
+                memcpy(l, line, n);
+                l[n] = '\0';
+                t->player = replay_role_player(l);
+                seated = 1;
+            }
             continue;
         }
-        if (strncmp(line, "ROLE WORDMASTER", 15) == 0) {
-            my_player_id = 0;
-            reset_row();
-            current_pass = 1;
-            current_turn = 0;
-            cursor_pos0 = 0;
-            render_screen(current_pass, cursor_pos0);
+        if (dir == TRACE_RECV) {
+            if ((n >= 10 && strncmp(line, "ENTER_WORD", 10) == 0) || (n >= 9 && strncmp(line, "YOUR_TURN", 9) == 0)) {
+                prompts++;
+                prompt_t = t_ns;
+            } else if (n >= 9 && strncmp(line, "GAME_OVER", 9) == 0) {
+                t->games++;
+            }
             continue;
         }
+        if (n >= 7 && strncmp(line, "RESUME ", 7) == 0) continue;     // a reconnect, not an answer
+        if (t->nsends == cap_sends) {
+            cap_sends = cap_sends ? cap_sends * 2 : 256;
+            char **l2 = realloc(t->line, (size_t)cap_sends * sizeof(char*));
+            int *p2 = l2 ? realloc(t->prompt, (size_t)cap_sends * sizeof(int)) : NULL;
+            uint64_t *g2 = p2 ? realloc(t->gap_ns, (size_t)cap_sends * sizeof(uint64_t)) : NULL;
+            if (l2) t->line = l2;
+            if (p2) t->prompt = p2;
+            if (g2) t->gap_ns = g2;
+            if (!g2) { ok = 0; break; }
+        }
+        uint64_t anchor = prompt_t > sent_t ? prompt_t : sent_t;
+        t->line[t->nsends] = strndup(line, n);
+        t->prompt[t->nsends] = prompts;
+        t->gap_ns[t->nsends] = t_ns - anchor;
+        if (!t->line[t->nsends]) { ok = 0; break; }
+        t->nsends++;
+        sent_t = t_ns;
+    }
+    free(buf);
+    return (ok && seated) ? 0 : -1;
+}
 
-        // Wordmaster prompt
-        if (strncmp(line, "ENTER_WORD", 10) == 0) {
-            printf("%s\n", line);
-            char word[64];
-            printf("Input (WORD ABCDE): ");
-            if (!fgets(word, sizeof(word), stdin)) break;
-            word[strcspn(word, "\r\n")] = 0;
-            send_line(fd, word);
-            continue;
+// Schedules the session's next trace line once its prompt has arrived
+static void replay_arm(load_t *L, load_session_t *s, uint64_t now) {
+    const replay_trace_t *t = s->trace;
+    if (!t || s->action != LOAD_ACT_NONE || s->next >= t->nsends) return;
+    int j = s->next;
+    if (s->prompts < t->prompt[j]) return;
+    uint64_t anchor = s->sent_ns;
+    if (s->prompts == t->prompt[j] && s->prompt_ns > anchor) anchor = s->prompt_ns;
+    uint64_t due = anchor + (L->speed > 0 ? (uint64_t)((double)t->gap_ns[j] / L->speed) : 0);
+    s->action = LOAD_ACT_REPLAY;
+    s->due_ns = due > now ? due : now;
+}
+
+// ROLE: take the next trace recorded in the same seat
+static void replay_bind(load_t *L, load_session_t *s) {
+    s->trace = NULL;
+    s->next = s->prompts = s->games_seen = 0;
+    s->prompt_ns = s->sent_ns = 0;
+    for (int i = 0; i < L->ntraces; i++) {
+        int k = (L->trace_rr + i) % L->ntraces;
+        if (L->traces[k].player == s->player) {
+            s->trace = &L->traces[k];
+            L->trace_rr = (k + 1) % L->ntraces;
+            return;
         }
+    }
+    L->unmatched++;
+}
 
-        if (strncmp(line, "GAME_OVER", 9) == 0) {
-            printf("\n=== GAME OVER ===\n");
-            printf("%s\n", line);
+static void load_act(load_t *L, load_session_t *s, uint64_t now) {
+    char line[64], w[MAX_WORD_LEN + 1];
+    int action = s->action;
+    s->action = LOAD_ACT_NONE;
+    if (action == LOAD_ACT_REPLAY) {
+        const char *l = s->trace->line[s->next++];
+        if (strncmp(l, "GUESS", 5) == 0) s->guess_sent_ns = now;
+        else if (strncmp(l, "WORD ", 5) == 0) L->words_sent++;
+        s->sent_ns = now;
+        L->replayed++;
+        load_send(L, s, l);
+        if (s->next >= s->trace->nsends && s->trace->games == 0) load_close(L, s);
+        else replay_arm(L, s, now);
+        return;
+    }
+    if (action == LOAD_ACT_WORD) {
+        load_random_word(L, s->len, w);
+        snprintf(line, sizeof(line), "WORD %s", w);
+        L->words_sent++;
+    } else if (s->word_rules) {
+        load_random_word(L, s->len, w);
+        snprintf(line, sizeof(line), "GUESSWORD %s", w);
+        s->guess_sent_ns = now;
+    } else {
+        snprintf(line, sizeof(line), "GUESS %c", load_pick_letter(L, s));
+        s->guess_sent_ns = now;
+    }
+    load_send(L, s, line);
+}
 
-            game_active = 0;   // <-- THIS IS STEP 3
+// Lines and frames share these handlers
+static void load_on_role(load_t *L, load_session_t *s, int player, int len, int word_rules) {
+    s->player = player;
+    s->len = (len >= DICT_MIN_LEN && len <= MAX_WORD_LEN) ? len : 5;
+    s->word_rules = word_rules;
+    if (L->ntraces) replay_bind(L, s);
+}
 
-            continue;
+// ENTER_WORD (pos 0) or YOUR_TURN (pos 1-based)
+static void load_on_prompt(load_t *L, load_session_t *s, int pos, uint64_t now) {
+    if (pos && s->state_ns) hist_record(&lat_turn, now - s->state_ns);
+    s->state_ns = 0;
+    if (L->ntraces) {
+        s->prompts++;
+        s->prompt_ns = now;
+        replay_arm(L, s, now);
+    } else if (!pos) {
+        load_schedule(L, s, LOAD_ACT_WORD, now);
+    } else {
+        s->pos = (pos - 1 < s->len) ? pos - 1 : 0;
+        load_schedule(L, s, LOAD_ACT_GUESS, now);
+    }
+}
+
+// pos: 1-based and letter 'A'..'Z' for a letter guess, else 0
+static void load_on_state(load_t *L, load_session_t *s, int from, int pos, char letter, uint64_t now) {
+    if (from == s->player && s->guess_sent_ns) {
+        hist_record(&lat_guess, now - s->guess_sent_ns);
+        s->guess_sent_ns = 0;
+        L->guesses++;
+    }
+    s->state_ns = now;
+    unsigned l = (unsigned)(letter - 'A');
+    if (pos >= 1 && pos <= MAX_WORD_LEN && l < 26) s->tried[pos - 1] |= 1u << l;
+}
+
+static void load_on_game_over(load_t *L, load_session_t *s) {
+    if (s->player == 1) L->games++;         // one count per room
+    memset(s->tried, 0, sizeof(s->tried));
+    s->state_ns = 0;
+    // A replayed session is done after its trace's last finished game
+    // (lines of a game the recording cut off are not replayed)
+    const replay_trace_t *t = s->trace;
+    if (t && t->games && ++s->games_seen >= t->games) load_close(L, s);
+}
+
+static void load_line(load_t *L, load_session_t *s, const char *line, uint64_t now) {
+    if (strncmp(line, "WELCOME", 7) == 0) {
+        s->binary = L->binary && strstr(line, WIRE_HELLO + 1) != NULL;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "NAME %s%d%s", L->name, (int)(s - L->s), s->binary ? WIRE_HELLO : "");
+        load_send(L, s, msg);
+    } else if (strncmp(line, "ROLE ", 5) == 0) {
+        proto_line_t f;
+        proto_parse(line, &f);
+        load_on_role(L, s, (strncmp(line, "ROLE GUESSER", 12) == 0) ? atoi(line + 12) : 0,
+                     proto_int(&f, PROTO_LEN, 5), proto_eq(&f, PROTO_RULES, "word"));
+    } else if (strncmp(line, "ENTER_WORD", 10) == 0) {
+        load_on_prompt(L, s, 0, now);
+    } else if (strncmp(line, "YOUR_TURN", 9) == 0) {
+        proto_line_t f;
+        proto_parse(line, &f);
+        int pos = proto_int(&f, PROTO_POS, 1);
+        load_on_prompt(L, s, pos >= 1 ? pos : 1, now);
+    } else if (strncmp(line, "STATE ", 6) == 0) {
+        proto_line_t f;
+        proto_parse(line, &f);
+        int guess = proto_has(&f, PROTO_GUESS) && proto_has(&f, PROTO_POS);
+        load_on_state(L, s, proto_int(&f, PROTO_FROM, -1), guess ? f.f[PROTO_POS].num : 0,
+                      guess ? f.f[PROTO_GUESS].p[0] : 0, now);
+    } else if (strncmp(line, "GAME_OVER", 9) == 0) {
+        load_on_game_over(L, s);
+    } else if (strncmp(line, "ERR ", 4) == 0) {
+        L->errors++;
+        // A rejected guess or word (e.g. not in the server's dictionary): try
+        // another (a trace carries its own retries)
+        if (!L->ntraces && strstr(line, "Not your turn") == NULL) {
+            if (s->guess_sent_ns) {
+                s->guess_sent_ns = 0;
+                load_schedule(L, s, LOAD_ACT_GUESS, now);
+            } else if (s->player == 0) {
+                load_schedule(L, s, LOAD_ACT_WORD, now);
+            }
+        }
+    }
+}
+
+// --binary sessions: the hot messages are read straight from the frame
+static void load_frame(load_t *L, load_session_t *s, const uint8_t *p, size_t n, uint64_t now) {
+    if (n == 0) return;
+    int type = p[0];
+    wire_role_t r;
+    wire_turn_t t;
+    wire_state_t st;
+    char line[WIRE_MAX_FRAME + 64];
+    switch (type) {
+    case WIRE_ROLE:
+        if (wire_get_role(p + 1, n - 1, &r) == 0) load_on_role(L, s, r.player, r.len, r.word_rules);
+        return;
+    case WIRE_YOUR_TURN:
+        if (wire_get_turn(p + 1, n - 1, &t) == 0) load_on_prompt(L, s, t.pos >= 1 ? t.pos : 1, now);
+        return;
+    case WIRE_STATE:
+    case WIRE_STATE_WORD:
+        if (wire_get_state(type, p + 1, n - 1, &st) == 0) {
+            load_on_state(L, s, st.from, st.word_rules ? 0 : st.pos, st.word_rules ? 0 : st.letter, now);
+        }
+        return;
+    case WIRE_GAME_OVER:
+        load_on_game_over(L, s);
+        return;
+    }
+    if (wire_text(line, sizeof(line), type, p + 1, n - 1) == 0) load_line(L, s, line, now);
+}
+
+static void load_read(load_t *L, load_session_t *s, uint64_t now) {
+    for (;;) {
+        ssize_t r = recv(s->fd, s->rbuf + s->rlen, LOAD_RBUF - s->rlen, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (r <= 0) { load_close(L, s); return; }
+        s->rlen += (size_t)r;
+        L->rx_bytes += (uint64_t)r;
+
+        char *start = s->rbuf, *nl;
+        while (s->state == LOAD_OPEN) {
+            size_t left = s->rlen - (size_t)(start - s->rbuf);
+            if (s->binary) {                    // set on WELCOME: frames from here on
+                if (left == 0 || left <= (size_t)(uint8_t)*start) break;
+                size_t flen = (uint8_t)*start;
+                load_frame(L, s, (const uint8_t*)start + 1, flen, now);
+                start += 1 + flen;
+            } else {
+                if (!(nl = memchr(start, '\n', left))) break;
+                *nl = '\0';
+                if (nl > start && nl[-1] == '\r') nl[-1] = '\0';
+                load_line(L, s, start, now);
+                start = nl + 1;
+            }
         }
+        if (s->state != LOAD_OPEN) return;
+        s->rlen -= (size_t)(start - s->rbuf);
+        memmove(s->rbuf, start, s->rlen);
+        if (s->rlen == LOAD_RBUF) s->rlen = 0;  // overlong line: drop it
+    }
+}
 
-        // Your turn prompt
-        if (strncmp(line, "YOUR_TURN", 8) == 0) {
-            int pass = current_pass;
-            int pos = cursor_pos0 + 1;
+static int load_connect(load_t *L, load_session_t *s, const struct sockaddr_in *addr) {
+    memset(s, 0, sizeof(*s));
+    s->player = -1;
+    s->len = 5;
+    s->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (s->fd < 0) return -1;
+    s->connect_start_ns = now_ns();
+    if (connect(s->fd, (const struct sockaddr*)addr, sizeof(*addr)) < 0 && errno != EINPROGRESS) {
+        close(s->fd);
+        return -1;
+    }
+    s->state = LOAD_CONNECTING;
+    struct epoll_event ev = { .events = EPOLLOUT, .data.u32 = (uint32_t)(s - L->s) };
+    if (epoll_ctl(L->epfd, EPOLL_CTL_ADD, s->fd, &ev) < 0) {
+        close(s->fd);
+        return -1;
+    }
+    return 0;
+}
+
+static void load_connected(load_t *L, load_session_t *s, uint64_t now) {
+    int err = 0;
+    socklen_t elen = sizeof(err);
+    getsockopt(s->fd, SOL_SOCKET, SO_ERROR, &err, &elen);
+    if (err) {
+        L->connect_failed++;
+        load_close(L, s);
+        return;
+    }
+    s->state = LOAD_OPEN;
+    if (!L->connected++) L->t_first_connect = now;
+    L->t_last_connect = now;
+    load_watch(L, s, EPOLLIN);
+}
+
+static int load_main(const char *ip, uint16_t port, const char *name, int n, int ports,
+                     int think_ms, int think_dist, int sweep, double duration, const char *dict_path,
+                     const char *replay, double speed, int binary) {
+    load_t L;
+    memset(&L, 0, sizeof(L));
+    L.speed = speed;
+    L.binary = binary;
+    if (replay) {
+        char paths[1024];
+        snprintf(paths, sizeof(paths), "%s", replay);
+        for (char *save = NULL, *path = strtok_r(paths, ",", &save); path; path = strtok_r(NULL, ",", &save)) {
+            replay_trace_t *grown = realloc(L.traces, (size_t)(L.ntraces + 1) * sizeof(replay_trace_t));
+            if (!grown) { perror("realloc"); return 1; }
+            L.traces = grown;
+            if (replay_load(path, &L.traces[L.ntraces]) != 0) {
+                fprintf(stderr, "%s: not a client trace with a ROLE line (record one with --record).\n", path);
+                return 1;
+            }
+            L.ntraces++;
+        }
+    }
+    L.n = n;
+    L.name = name;
+    L.think_ns = (uint64_t)think_ms * 1000000ull;
+    L.think_dist = think_dist;
+    L.sweep = sweep;
+    L.rng = now_ns() ^ ((uint64_t)getpid() << 32);
+    if (!L.rng) L.rng = 1;
+    load_dict(&L, dict_path);
 
-            char *p_pass = strstr(line, "pass=");
-            if (p_pass) pass = atoi(p_pass + 5);
-            char *p_pos = strstr(line, "pos=");
-            if (p_pos) pos = atoi(p_pos + 4);
+    L.s = calloc((size_t)n, sizeof(load_session_t));
+    L.epfd = epoll_create1(0);
+    if (!L.s || L.epfd < 0) { perror("load setup"); return 1; }
 
-            current_pass = pass;
-            cursor_pos0 = (pos > 0) ? (pos - 1) : 0;
-            current_turn = my_player_id;
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = load_sigint;
+    sigaction(SIGINT, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+        fprintf(stderr, "Invalid IP: %s\n", ip);
+        return 1;
+    }
 
-            render_screen(current_pass, cursor_pos0);
-            printf("Input letter: \033[K");
-            fflush(stdout);
+    uint64_t t0 = now_ns();
+    for (int i = 0; i < n; i++) {
+        addr.sin_port = htons((uint16_t)(port + i % ports));
+        if (load_connect(&L, &L.s[i], &addr) != 0) {
+            L.s[i].state = LOAD_CLOSED;
+            L.connect_failed++;
+            L.closed++;
+        }
+    }
 
-            printf("Input letter: ");
-            fflush(stdout);
+    struct epoll_event evs[256];
+    uint64_t next_due = UINT64_MAX;
+    uint64_t end = duration > 0 ? t0 + (uint64_t)(duration * 1e9) : UINT64_MAX;
+    while (!g_load_stop && L.closed < (uint64_t)n) {
+        uint64_t now = now_ns();
+        if (now >= end) break;
+        uint64_t wake = next_due < end ? next_due : end;
+        int timeout = 100;
+        if (wake != UINT64_MAX) {
+            uint64_t ms = wake > now ? (wake - now + 999999) / 1000000 : 0;
+            if (ms < (uint64_t)timeout) timeout = (int)ms;
+        }
 
-            char guess[64];
-            if (!fgets(guess, sizeof(guess), stdin)) break;
-            guess[strcspn(guess, "\r\n")] = 0;
+        int k = epoll_wait(L.epfd, evs, 256, timeout);
+        if (k < 0 && errno != EINTR) { perror("epoll_wait"); break; }
+        if (lat_report_req) {
+            lat_report_req = 0;
+            lat_report("SIGUSR1", 0);
+        }
+        now = now_ns();
+        for (int e = 0; e < k; e++) {
+            load_session_t *s = &L.s[evs[e].data.u32];
+            if (s->state == LOAD_CONNECTING) {
+                load_connected(&L, s, now);
+                continue;
+            }
+            if (s->state != LOAD_OPEN) continue;
+            if (evs[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) load_read(&L, s, now);
+            if (s->state == LOAD_OPEN && (evs[e].events & EPOLLOUT)) load_flush(&L, s);
+        }
 
-            if (strlen(guess) == 1 &&
-                ((guess[0] >= 'A' && guess[0] <= 'Z') || (guess[0] >= 'a' && guess[0] <= 'z'))) {
-                char out[64];
-                snprintf(out, sizeof(out), "GUESS %c", guess[0]);
-                send_line(fd, out);
-            } else {
-                send_line(fd, guess);
+        // Fire due think timers; rescan only once the earliest is due
+        if (now >= next_due || k > 0) {
+            next_due = UINT64_MAX;
+            for (int i = 0; i < n; i++) {
+                load_session_t *s = &L.s[i];
+                if (s->action == LOAD_ACT_NONE) continue;
+                if (s->due_ns <= now) load_act(&L, s, now);
+                if (s->action != LOAD_ACT_NONE && s->due_ns < next_due) next_due = s->due_ns;
             }
+        }
+    }
+    double secs = (double)(now_ns() - t0) / 1e9;
+    for (int i = 0; i < n; i++) load_close(&L, &L.s[i]);
+    close(L.epfd);
+
+    double conn_secs = L.connected ? (double)(L.t_last_connect - t0) / 1e9 : 0.0;
+    printf("load: %d sessions over %d port(s) from %u, %llu connected (%llu failed) in %.3f s: %.0f connects/s\n",
+           n, ports, (unsigned)port, (unsigned long long)L.connected, (unsigned long long)L.connect_failed,
+           conn_secs, conn_secs > 0 ? (double)L.connected / conn_secs : 0.0);
+    printf("ran %.1f s: %llu games (%.1f games/s), %llu guesses (%.0f/s), %llu words set, %llu ERR lines\n",
+           secs, (unsigned long long)L.games, secs > 0 ? (double)L.games / secs : 0.0,
+           (unsigned long long)L.guesses, secs > 0 ? (double)L.guesses / secs : 0.0,
+           (unsigned long long)L.words_sent, (unsigned long long)L.errors);
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    double cpu_us = (double)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e6 + (double)(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+    double games = L.games ? (double)L.games : 1.0;
+    printf("wire: %s, %llu bytes received (%.0f/game), client CPU %.1f s (%.0f us/game)\n",
+           L.binary ? "binary frames" : "text lines", (unsigned long long)L.rx_bytes,
+           (double)L.rx_bytes / games, cpu_us / 1e6, cpu_us / games);
+    if (L.ntraces) {
+        char sp[32] = "max";
+        if (L.speed > 0) snprintf(sp, sizeof(sp), "%gx", L.speed);
+        printf("replay: %d trace(s) at %s speed, %llu lines replayed (%.0f/s), %llu sessions had no trace for their seat\n",
+               L.ntraces, sp, (unsigned long long)L.replayed,
+               secs > 0 ? (double)L.replayed / secs : 0.0, (unsigned long long)L.unmatched);
+    }
+    lat_report("exit", 0);
+    for (int t = 0; t < L.ntraces; t++) {
+        for (int i = 0; i < L.traces[t].nsends; i++) free(L.traces[t].line[i]);
+        free(L.traces[t].line);
+        free(L.traces[t].prompt);
+        free(L.traces[t].gap_ns);
+    }
+    free(L.traces);
+    free(L.words);
+    free(L.s);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int load = 0, ports = 1, think_ms = 0, think_dist = THINK_UNIFORM, sweep = 0, bad = 0;
+    double duration = 0;
+    const char *dict_path = "dict.idx";
+    const char *record_path = NULL, *replay = NULL;
+    double speed = 1.0;
+    int argi = 1;
+    for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+        const char *a = argv[argi];
+        if (strncmp(a, "--load=", 7) == 0) load = atoi(a + 7);
+        else if (strncmp(a, "--ports=", 8) == 0) ports = atoi(a + 8);
+        else if (strncmp(a, "--think=", 8) == 0) think_ms = atoi(a + 8);
+        else if (strncmp(a, "--think-dist=", 13) == 0) bad |= (think_dist = think_dist_parse(a + 13)) < 0;
+        else if (strncmp(a, "--bot=", 6) == 0) {
+            cbot_on = 1;
+            bad |= bot_strategy_parse(a + 6, &cbot_strategy) != 0;
+        }
+        else if (strncmp(a, "--duration=", 11) == 0) duration = atof(a + 11);
+        else if (strncmp(a, "--dict=", 7) == 0) dict_path = a + 7;
+        else if (strncmp(a, "--latency=", 10) == 0) lat_path = a + 10;
+        else if (strncmp(a, "--record=", 9) == 0) record_path = a + 9;
+        else if (strncmp(a, "--resume=", 9) == 0) snprintf(sess_token, sizeof(sess_token), "%s", a + 9);
+        else if (strcmp(a, "--binary") == 0) wire_want = 1;
+        else if (strncmp(a, "--replay=", 9) == 0) replay = a + 9;
+        else if (strcmp(a, "--speed=max") == 0) speed = 0;
+        else if (strncmp(a, "--speed=", 8) == 0) bad |= (speed = atof(a + 8)) <= 0;
+        else if (strcmp(a, "--strategy=random") == 0) sweep = 0;
+        else if (strcmp(a, "--strategy=sweep") == 0) sweep = 1;
+        else { argi = argc; break; }
+    }
+    if (argc - argi != 3 || bad || load < 0 || ports < 1 || think_ms < 0 ||
+        (load && (cbot_on || record_path || sess_token[0])) || (replay && !load)) {
+        fprintf(stderr, "Usage: %s [--latency=FILE] [--record=FILE] [--resume=TOKEN] [--binary] <server_ip> <port> <name>\n"
+                        "       %s --bot=info|freq|random [--think=MS] [--think-dist=fixed|uniform|exp]\n"
+                        "          [--dict=dict.idx] <server_ip> <port> <name>\n"
+                        "       %s --load=N [--ports=K] [--think=MS] [--think-dist=...] [--strategy=random|sweep]\n"
+                        "          [--duration=SEC] [--dict=dict.idx] [--binary] <server_ip> <port> <name>\n"
+                        "       %s --load=N --replay=FILE[,FILE...] [--speed=X|max] [--ports=K]\n"
+                        "          [--duration=SEC] <server_ip> <port> <name>\n",
+                argv[0], argv[0], argv[0], argv[0]);
+        return 1;
+    }
+    lat_install();
+    if (load) {
+        return load_main(argv[argi], (uint16_t)atoi(argv[argi + 1]), argv[argi + 2],
+                         load, ports, think_ms, think_dist, sweep, duration, replay ? NULL : dict_path,
+                         replay, speed, wire_want);
+    }
+    if (cbot_on) {
+        if (dict_open(&cbot_dict, dict_path) != 0) {
+            fprintf(stderr, "Cannot open %s (build it with dictbuild).\n", dict_path);
+            return 1;
+        }
+        cbot_rng = (now_ns() ^ ((uint64_t)getpid() << 32)) | 1;
+        cbot_think_ns = (uint64_t)think_ms * 1000000ull;
+        cbot_think_dist = think_dist;
+    }
+
+    const char *ip = argv[argi];
+    uint16_t port = (uint16_t)atoi(argv[argi + 1]);
+    const char *name = argv[argi + 2];
+
+    if (record_path && trace_start(record_path) != 0) {
+        perror(record_path);
+        return 1;
+    }
+    int fd = connect_to(ip, port);
+    if (fd < 0) {
+        perror("connect");
+        return 1;
+    }
+    if (session_hello(fd, name, 1) != 0) {
+        fprintf(stderr, sess_token[0] ? "Session could not be resumed.\n" : "Server closed.\n");
+        close(fd);
+        return 1;
+    }
+
+    if (!cbot_on) input_init();
+    char rbuf[4096];
+    size_t rlen = 0;
+    uint64_t bot_due_ms = 0;                // --bot: answer the open prompt then
+    int bot_armed = 0;
+
+    while (1) {
+        // Draw a pending frame once the interval since the last one has passed,
+        // or sooner if nothing arrives meanwhile; lines that arrive in between
+        // update the same frame
+        int wait = -1;
+        if (scr_pending) {
+            uint64_t el = now_ns() / 1000000ull - scr_last_ms;
+            wait = el >= SCREEN_REFRESH_MS ? 0 : (int)(SCREEN_REFRESH_MS - el);
+            if (wait == 0) {
+                screen_flush();
+                wait = -1;
+            }
+        }
+        if (bot_armed) {
+            uint64_t now = now_ns() / 1000000ull;
+            if (in_mode == INPUT_NONE) {
+                bot_armed = 0;
+            } else if (now >= bot_due_ms) {
+                cbot_answer(in_mode == INPUT_WORD);
+                bot_armed = 0;
+                input_finish(fd);
+                render_screen(current_pass, cursor_pos0);
+                continue;
+            } else if (wait < 0 || bot_due_ms - now < (uint64_t)wait) wait = (int)(bot_due_ms - now);
+        }
+
+        struct pollfd pfd[2] = {
+            { .fd = fd, .events = POLLIN },
+            { .fd = STDIN_FILENO, .events = POLLIN },
+        };
+        int watch_stdin = !cbot_on && in_mode != INPUT_NONE && !in_eof;
+        int n = poll(pfd, watch_stdin ? 2 : 1, wait);
+        if (n < 0 && errno == EINTR) {
+            if (lat_report_req) {
+                lat_report_req = 0;
+                lat_report("SIGUSR1", 1);
+                render_screen(current_pass, cursor_pos0);
+            }
+            continue;
+        }
+        if (n < 0) break;
+        if (n == 0) {
+            if (scr_pending) screen_flush();
             continue;
         }
 
-        // Game over: print message (screen will already show last STATE)
-        // if (strncmp(line, "GAME_OVER", 9) == 0) {
-        //     printf("%s\n", line);
-        //     continue;
-        // }
+        // Keystrokes are echoed at once; the diff is a few bytes
+        if (watch_stdin && pfd[1].revents) {
+            ssize_t r = read(STDIN_FILENO, in_raw + in_raw_len, sizeof(in_raw) - (size_t)in_raw_len);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) in_eof = 1;
+            else in_raw_len += (int)r;
+            if (input_consume(fd)) screen_flush();
+        }
+
+        if (pfd[0].revents) {
+            ssize_t r = recv(fd, rbuf + rlen, sizeof(rbuf) - rlen, 0);
+            if (r < 0 && errno == EINTR) continue;
+            lat_rx_ns = now_ns();
+            if (r <= 0 && sess_token[0] && sess_grace_s > 0) {
+                // Dropped: the server holds our slot for the grace period
+                close(fd);
+                rlen = 0;
+                bot_armed = 0;
+                session_lost();
+                fd = session_reconnect(ip, port, name);
+                if (fd >= 0) continue;
+            }
+            if (r <= 0) {
+                if (scr_pending) screen_flush();
+                printf("\nDisconnected.\n");
+                break;
+            }
+            rlen += (size_t)r;
+
+            char *start = rbuf, *nl;
+            while (wire_on && rlen - (size_t)(start - rbuf) > (size_t)(uint8_t)*start) {
+                size_t flen = (uint8_t)*start;
+                int had_prompt = in_mode != INPUT_NONE;
+                handle_frame((const uint8_t*)start + 1, flen);
+                if (!had_prompt && in_mode != INPUT_NONE) screen_flush();   // show a new prompt at once
+                start += 1 + flen;
+            }
+            while (!wire_on && (nl = memchr(start, '\n', rlen - (size_t)(start - rbuf)))) {
+                *nl = '\0';
+                if (nl > start && nl[-1] == '\r') nl[-1] = '\0';
+                int had_prompt = in_mode != INPUT_NONE;
+                if (trc_out) trace_record(TRACE_RECV, start);
+                handle_line(start);
+                if (!had_prompt && in_mode != INPUT_NONE) screen_flush();   // show a new prompt at once
+                start = nl + 1;
+            }
+            rlen -= (size_t)(start - rbuf);
+            memmove(rbuf, start, rlen);
+            if (rlen == sizeof(rbuf)) rlen = 0;     // overlong line: drop it
 
-        // Default: print other messages
-        printf("%s\n", line);
+            // Lines typed (or piped) ahead answer a prompt that just opened
+            if (input_consume(fd)) screen_flush();
+
+            if (cbot_on && in_mode != INPUT_NONE && !bot_armed) {
+                bot_due_ms = now_ns() / 1000000ull + think_sample_ns(cbot_think_ns, cbot_think_dist, &cbot_rng) / 1000000ull;
+                bot_armed = 1;
+            }
+        }
+
+        // stdin closed with a prompt open: nothing can answer it
+        if (!cbot_on && in_mode != INPUT_NONE && in_eof && in_raw_len == 0) break;
     }
 
-    close(fd);
+    lat_report("exit", 0);
+    if (trc_out) fclose(trc_out);
+    if (cbot_len) bot_free(&cbot);
+    if (cbot_on) dict_close(&cbot_dict);
+
+    if (fd >= 0) close(fd);
     return 0;
 }
@@ -0,0 +1,207 @@
+// dict.h - Prebuilt dictionary index (dict.idx), mmapped read-only
+//
+// Built offline by dictbuild from a plain word list. Opening it is an mmap,
+// a header check and one pass counting each section's words (~2 MB for the
+// bitsets); every lookup is O(1) with no parsing at startup.
+//   - lengths up to DICT_BITSET_MAX_LEN: one bit per word in the full 26^len
+//     space (26^5 bits = 1.5 MB), bit index = word read as a base-26 number
+//   - longer lengths: open-addressed table of packed words (5 bits/letter,
+//     +1 so 0 marks an empty slot), power-of-two size, at most half full
+
+#ifndef DICT_H
+#define DICT_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DICT_MAGIC 0x31544344u    // "DCT1"
+#define DICT_MIN_LEN 4
+#define DICT_MAX_LEN 12
+#define DICT_BITSET_MAX_LEN 5
+
+enum { DICT_NONE = 0, DICT_BITSET = 1, DICT_HASH = 2 };
+
+typedef struct {
+    uint64_t offset;              // from start of file, 8-byte aligned
+    uint32_t kind;                // DICT_*
+    uint32_t reserved;
+    uint64_t slots;               // bits (BITSET) or uint64 slots (HASH)
+    uint64_t count;               // words of this length
+} dict_section_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t reserved;
+    dict_section_t sec[DICT_MAX_LEN + 1];   // indexed by word length
+} dict_header_t;
+
+typedef struct {
+    const dict_header_t *hdr;
+    const uint8_t *base;
+    size_t map_len;
+} dict_t;
+
+static inline uint64_t dict_mix64(uint64_t x) {
+    x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+// Bitset index: the word read as a base-26 number. Both encoders set
+// *ok = 0 on a letter outside A-Z.
+static inline uint64_t dict_base26(const char *w, int len, int *ok) {
+    uint64_t v = 0;
+    for (int i = 0; i < len; i++) {
+        unsigned l = (unsigned)(w[i] - 'A');
+        if (l >= 26) { *ok = 0; return 0; }
+        v = v * 26 + l;
+    }
+    *ok = 1;
+    return v;
+}
+
+// Hash key: 5 bits per letter, +1 so no word packs to the empty-slot 0
+static inline uint64_t dict_pack(const char *w, int len, int *ok) {
+    uint64_t v = 0;
+    for (int i = 0; i < len; i++) {
+        unsigned l = (unsigned)(w[i] - 'A');
+        if (l >= 26) { *ok = 0; return 0; }
+        v |= (uint64_t)l << (5 * i);
+    }
+    *ok = 1;
+    return v + 1;
+}
+
+// Words dict_foreach() would yield from a section already known to be in
+// bounds: set bits of a bitset, non-empty slots of a hash table
+static inline uint64_t dict_section_words(const uint8_t *base, const dict_section_t *s) {
+    uint64_t n = 0;
+    if (s->kind == DICT_BITSET) {
+        const uint8_t *bits = base + s->offset;
+        for (uint64_t byte = 0; byte < (s->slots + 7) / 8; byte++) n += (uint64_t)__builtin_popcount(bits[byte]);
+    } else if (s->kind == DICT_HASH) {
+        const uint64_t *slot = (const uint64_t*)(base + s->offset);
+        for (uint64_t i = 0; i < s->slots; i++) n += slot[i] != 0;
+    }
+    return n;
+}
+
+static inline int dict_open(dict_t *d, const char *path) {
+    memset(d, 0, sizeof(*d));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(dict_header_t)) {
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    // Every section must be safe to look up in: in bounds, a bitset covering
+    // all 26^len words, a hash table of 2^k slots with at least one empty.
+    // count must match the contents: callers size dict_foreach() buffers by it
+    const dict_header_t *h = (const dict_header_t*)map;
+    uint64_t size = (uint64_t)st.st_size;
+    int ok = (h->magic == DICT_MAGIC);
+    for (int len = 0; ok && len <= DICT_MAX_LEN; len++) {
+        const dict_section_t *s = &h->sec[len];
+        uint64_t words = 1;
+        for (int i = 0; i < len; i++) words *= 26;
+        if (s->kind == DICT_NONE) { ok = s->count == 0; continue; }
+        if (s->kind == DICT_BITSET) {
+            ok = s->slots >= words && s->slots / 8 < size && s->offset % 8 == 0 &&
+                 s->offset <= size - (s->slots + 7) / 8;
+        } else if (s->kind == DICT_HASH) {
+            ok = s->slots != 0 && !(s->slots & (s->slots - 1)) && s->count < s->slots &&
+                 s->slots < size / 8 && s->offset % 8 == 0 && s->offset <= size - s->slots * 8;
+        } else {
+            ok = 0;
+        }
+        ok = ok && s->count == dict_section_words((const uint8_t*)map, s);
+    }
+    if (!ok) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    d->hdr = h;
+    d->base = (const uint8_t*)map;
+    d->map_len = (size_t)st.st_size;
+    return 0;
+}
+
+static inline void dict_close(dict_t *d) {
+    if (d->hdr) munmap((void*)d->base, d->map_len);
+    memset(d, 0, sizeof(*d));
+}
+
+// Words of this length known to the index (0 if the index has none)
+static inline uint64_t dict_count(const dict_t *d, int len) {
+    if (!d->hdr || len < 0 || len > DICT_MAX_LEN) return 0;
+    return d->hdr->sec[len].count;
+}
+
+// w: len uppercase letters
+static inline int dict_contains(const dict_t *d, const char *w, int len) {
+    if (!d->hdr || len < 0 || len > DICT_MAX_LEN) return 0;
+    const dict_section_t *s = &d->hdr->sec[len];
+    int ok;
+
+    if (s->kind == DICT_BITSET) {
+        uint64_t v = dict_base26(w, len, &ok);
+        if (!ok) return 0;
+        return (d->base[s->offset + v / 8] >> (v % 8)) & 1u;
+    }
+    if (s->kind == DICT_HASH) {
+        uint64_t key = dict_pack(w, len, &ok);
+        if (!ok) return 0;
+        const uint64_t *slot = (const uint64_t*)(d->base + s->offset);
+        uint64_t mask = s->slots - 1;
+        uint64_t i = dict_mix64(key) & mask;
+        // Bounded too: count only says the table has an empty slot
+        for (uint64_t n = 0; n < s->slots && slot[i]; n++, i = (i + 1) & mask) {
+            if (slot[i] == key) return 1;
+        }
+    }
+    return 0;
+}
+
+// Calls fn(word, ctx) for every word of length len; word is NUL-terminated
+// uppercase. Walks the whole section, so this is for startup, not lookups.
+static inline void dict_foreach(const dict_t *d, int len, void (*fn)(const char *word, void *ctx), void *ctx) {
+    if (!d->hdr || len < DICT_MIN_LEN || len > DICT_MAX_LEN) return;
+    const dict_section_t *s = &d->hdr->sec[len];
+    char w[DICT_MAX_LEN + 1];
+    w[len] = '\0';
+
+    if (s->kind == DICT_BITSET) {
+        const uint8_t *bits = d->base + s->offset;
+        for (uint64_t byte = 0; byte < (s->slots + 7) / 8; byte++) {
+            if (!bits[byte]) continue;
+            for (int b = 0; b < 8; b++) {
+                if (!((bits[byte] >> b) & 1u)) continue;
+                uint64_t v = byte * 8 + (uint64_t)b;
+                for (int i = len - 1; i >= 0; i--) { w[i] = (char)('A' + v % 26); v /= 26; }
+                fn(w, ctx);
+            }
+        }
+    } else if (s->kind == DICT_HASH) {
+        const uint64_t *slot = (const uint64_t*)(d->base + s->offset);
+        for (uint64_t i = 0; i < s->slots; i++) {
+            if (!slot[i]) continue;
+            uint64_t v = slot[i] - 1;
+            for (int k = 0; k < len; k++) w[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+            fn(w, ctx);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,147 @@
+// dictbuild.c - Build dict.idx (see dict.h) from a plain word list
+// Build: gcc -O2 -Wall -Wextra -pedantic dictbuild.c -o dictbuild
+//
+// Usage:
+//   ./dictbuild <words.txt> [dict.idx]
+//
+// One word per line; case is ignored. Lines with anything but letters, or
+// with a length outside DICT_MIN_LEN..DICT_MAX_LEN, are skipped.
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dict.h"
+
+typedef struct {
+    uint64_t *keys;
+    size_t n;
+    size_t cap;
+} keys_t;
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void keys_push(keys_t *k, uint64_t v) {
+    if (k->n == k->cap) {
+        k->cap = k->cap ? k->cap * 2 : 1024;
+        k->keys = realloc(k->keys, k->cap * sizeof(uint64_t));
+        if (!k->keys) { perror("realloc"); exit(1); }
+    }
+    k->keys[k->n++] = v;
+}
+
+static uint64_t pow26(int len) {
+    uint64_t v = 1;
+    for (int i = 0; i < len; i++) v *= 26;
+    return v;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <words.txt> [dict.idx]\n", argv[0]);
+        return 1;
+    }
+    const char *in_path = argv[1];
+    const char *out_path = (argc > 2) ? argv[2] : "dict.idx";
+
+    FILE *in = fopen(in_path, "r");
+    if (!in) { perror("fopen"); return 1; }
+
+    // Bitset lengths keep base-26 values, hashed lengths keep packed keys
+    keys_t keys[DICT_MAX_LEN + 1];
+    memset(keys, 0, sizeof(keys));
+    size_t skipped = 0;
+
+    char line[256];
+    while (fgets(line, sizeof(line), in)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        int len = (int)strlen(line);
+        int ok = (len >= DICT_MIN_LEN && len <= DICT_MAX_LEN);
+        for (int i = 0; ok && i < len; i++) {
+            if (!isalpha((unsigned char)line[i])) ok = 0;
+            line[i] = (char)toupper((unsigned char)line[i]);
+        }
+        if (!ok) { skipped++; continue; }
+
+        uint64_t v = (len <= DICT_BITSET_MAX_LEN) ? dict_base26(line, len, &ok) : dict_pack(line, len, &ok);
+        keys_push(&keys[len], v);
+    }
+    fclose(in);
+
+    dict_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = DICT_MAGIC;
+
+    // Lay out sections after the header, 8-byte aligned
+    uint64_t off = (sizeof(hdr) + 7) & ~7ull;
+    for (int len = DICT_MIN_LEN; len <= DICT_MAX_LEN; len++) {
+        keys_t *k = &keys[len];
+        if (k->n == 0) continue;
+
+        qsort(k->keys, k->n, sizeof(uint64_t), cmp_u64);
+        size_t u = 0;
+        for (size_t i = 0; i < k->n; i++) {
+            if (u == 0 || k->keys[i] != k->keys[u - 1]) k->keys[u++] = k->keys[i];
+        }
+        k->n = u;
+
+        dict_section_t *s = &hdr.sec[len];
+        s->offset = off;
+        s->count = k->n;
+        if (len <= DICT_BITSET_MAX_LEN) {
+            s->kind = DICT_BITSET;
+            s->slots = pow26(len);
+            off += ((s->slots + 7) / 8 + 7) & ~7ull;
+        } else {
+            s->kind = DICT_HASH;
+            s->slots = 8;
+            while (s->slots < 2 * k->n) s->slots *= 2;
+            off += s->slots * 8;
+        }
+    }
+
+    uint8_t *img = calloc(1, (size_t)off);
+    if (!img) { perror("calloc"); return 1; }
+    memcpy(img, &hdr, sizeof(hdr));
+
+    for (int len = DICT_MIN_LEN; len <= DICT_MAX_LEN; len++) {
+        const dict_section_t *s = &hdr.sec[len];
+        const keys_t *k = &keys[len];
+        if (s->kind == DICT_BITSET) {
+            uint8_t *bits = img + s->offset;
+            for (size_t i = 0; i < k->n; i++) bits[k->keys[i] / 8] |= (uint8_t)(1u << (k->keys[i] % 8));
+        } else if (s->kind == DICT_HASH) {
+            uint64_t *slot = (uint64_t*)(img + s->offset);
+            uint64_t mask = s->slots - 1;
+            for (size_t i = 0; i < k->n; i++) {
+                uint64_t j = dict_mix64(k->keys[i]) & mask;
+                while (slot[j]) j = (j + 1) & mask;
+                slot[j] = k->keys[i];
+            }
+        }
+        free(k->keys);
+    }
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", out_path);
+    FILE *out = fopen(tmp, "wb");
+    if (!out) { perror("fopen"); return 1; }
+    int err = fwrite(img, 1, (size_t)off, out) != (size_t)off;
+    if (fclose(out) != 0) err = 1;
+    if (err || rename(tmp, out_path) != 0) { perror("write"); return 1; }
+    free(img);
+
+    for (int len = DICT_MIN_LEN; len <= DICT_MAX_LEN; len++) {
+        if (hdr.sec[len].count) {
+            printf("len %2d: %8llu words (%s)\n", len, (unsigned long long)hdr.sec[len].count,
+                   hdr.sec[len].kind == DICT_BITSET ? "bitset" : "hash");
+        }
+    }
+    printf("Wrote %s (%llu bytes), skipped %zu lines.\n", out_path, (unsigned long long)off, skipped);
+    return 0;
+}
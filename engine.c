@@ -0,0 +1,215 @@
+// engine.c - Word guessing rules engine (see engine.h)
+//
+// ENGINE_SPECIALIZE(N) stamps out new_game/apply/snapshot for one word
+// length with N as a constant, so the compiler unrolls the per-letter loops
+// and folds the end-of-row and all-revealed checks. The public functions
+// switch on g->len once per call.
+
+#include "engine.h"
+
+// Word-rule feedback on 5-bit packed words. low has bit 5i set for every
+// position; zero_groups() turns each all-zero 5-bit group of x into its low
+// bit, so (a ^ b) compares all positions at once and (a ^ letter * low)
+// finds every position holding one letter. Counting such flags is one
+// multiply: x * low sums every group's flag into group n-1 (at most 12, so
+// no carries cross groups). With n constant (the specializations below) the
+// loop unrolls into straight-line code.
+static inline unsigned long long zero_groups(unsigned long long x, unsigned long long low) {
+    return low & ~(x | x >> 1 | x >> 2 | x >> 3 | x >> 4);
+}
+
+static inline int count_groups(unsigned long long flags, unsigned long long low, int n) {
+    return (int)(((flags * low) >> (5 * (n - 1))) & 31u);
+}
+
+static inline unsigned int word_feedback_n(unsigned long long s, unsigned long long g, int n) {
+    unsigned long long low = 0;
+    for (int i = 0; i < n; i++) low |= 1ull << (5 * i);
+
+    unsigned long long green = zero_groups(s ^ g, low);
+    unsigned long long open = low & ~green;             // positions left for PRESENT
+    unsigned int fb = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned long long splat = ((g >> (5 * i)) & 31u) * low;
+        unsigned long long before = (1ull << (5 * i)) - 1;
+        int in_secret = count_groups(zero_groups(s ^ splat, low) & open, low, n);
+        int used = count_groups(zero_groups(g ^ splat, low) & open & before, low, n);
+        unsigned int is_green = (unsigned int)(green >> (5 * i)) & 1u;
+        unsigned int is_present = (unsigned int)((open >> (5 * i)) & 1u) & (unsigned int)(used < in_secret);
+        fb |= (is_green * ENGINE_CORRECT | is_present * ENGINE_PRESENT) << (2 * i);
+    }
+    return fb;
+}
+
+#define ENGINE_SPECIALIZE(N)                                                          \
+static void new_game_##N(engine_game_t *g, const char *secret) {                      \
+    for (int i = 0; i < N; i++) {                                                     \
+        g->secret[i] = secret ? secret[i] : '_';                                      \
+        g->display[i] = '_';                                                          \
+    }                                                                                 \
+    g->secret[N] = '\0';                                                              \
+    g->display[N] = '\0';                                                             \
+                                                                                      \
+    g->present_mask = 0;                                                              \
+    for (int i = 0; i < N; i++) {                                                     \
+        unsigned l = (unsigned)(g->secret[i] - 'A');                                  \
+        if (l < ENGINE_ALPHABET) g->present_mask |= 1u << l;                          \
+    }                                                                                 \
+    for (int l = 0; l < ENGINE_ALPHABET; l++) {                                       \
+        unsigned char base = (g->present_mask >> l) & 1u ? ENGINE_PRESENT : ENGINE_ABSENT; \
+        for (int i = 0; i < N; i++) {                                                 \
+            g->feedback[l][i] = (g->secret[i] == 'A' + l) ? ENGINE_CORRECT : base;    \
+        }                                                                             \
+    }                                                                                 \
+}                                                                                     \
+                                                                                      \
+static engine_result_t apply_##N(engine_game_t *g, char letter, engine_move_t *mv) {  \
+    int player = g->turn;                                                             \
+    int pos = g->pos;                                                                 \
+    unsigned l = (unsigned)(letter - 'A');                                            \
+    engine_result_t r = (l < ENGINE_ALPHABET) ? (engine_result_t)g->feedback[l][pos]  \
+                                              : ENGINE_ABSENT;                        \
+                                                                                      \
+    if (r == ENGINE_CORRECT) {                                                        \
+        g->score[player] += 1;                                                        \
+        if (g->display[pos] == '_') {                                                 \
+            g->display[pos] = letter;                                                 \
+            g->revealed += 1;                                                         \
+        }                                                                             \
+    }                                                                                 \
+                                                                                      \
+    /* Advance (one guess per position) */                                            \
+    int wrapped = (pos == N - 1);                                                     \
+    g->pos = wrapped ? 0 : pos + 1;                                                   \
+    g->pass += wrapped;                                                               \
+                                                                                      \
+    if (g->revealed == N || g->pass >= ENGINE_MAX_PASSES) g->over = 1;                \
+    else g->turn = (player == 1) ? 2 : 1;                                             \
+                                                                                      \
+    if (mv) {                                                                         \
+        mv->player = player;                                                          \
+        mv->pass = g->pass - wrapped;                                                 \
+        mv->pos = pos;                                                                \
+        mv->letter = letter;                                                          \
+        mv->result = r;                                                               \
+        mv->over = g->over;                                                           \
+    }                                                                                 \
+    return r;                                                                         \
+}                                                                                     \
+                                                                                      \
+static unsigned int apply_word_##N(engine_game_t *g, const char *guess,              \
+                                   engine_word_move_t *mv) {                          \
+    int player = g->turn;                                                             \
+    unsigned int fb = word_feedback_n(engine_pack_word(g->secret, N),                   \
+                                      engine_pack_word(guess, N), N);                 \
+    int gained = 0;                                                                   \
+    for (int i = 0; i < N; i++) {                                                     \
+        int fresh = ENGINE_FEEDBACK_AT(fb, i) == ENGINE_CORRECT && g->display[i] == '_'; \
+        if (fresh) g->display[i] = guess[i];                                          \
+        gained += fresh;                                                              \
+    }                                                                                 \
+    g->revealed += gained;                                                            \
+    g->score[player] += gained;                                                       \
+                                                                                      \
+    int wrapped = (player == 2);        /* a pass is one word from each guesser */    \
+    g->pass += wrapped;                                                               \
+    if (g->revealed == N || g->pass >= ENGINE_MAX_PASSES) g->over = 1;                \
+    else g->turn = (player == 1) ? 2 : 1;                                             \
+                                                                                      \
+    if (mv) {                                                                         \
+        mv->player = player;                                                          \
+        mv->pass = g->pass - wrapped;                                                 \
+        mv->feedback = fb;                                                            \
+        mv->revealed = gained;                                                        \
+        mv->over = g->over;                                                           \
+    }                                                                                 \
+    return fb;                                                                        \
+}                                                                                     \
+                                                                                      \
+static void snapshot_##N(const engine_game_t *g, engine_snapshot_t *out) {            \
+    for (int i = 0; i <= N; i++) out->display[i] = g->display[i];                     \
+    out->pass = g->pass;                                                              \
+    out->pos = g->pos;                                                                \
+    out->turn = g->over ? 0 : g->turn;                                                \
+    out->over = g->over;                                                              \
+    out->score_a = g->score[1];                                                       \
+    out->score_b = g->score[2];                                                       \
+}
+
+ENGINE_SPECIALIZE(4)
+ENGINE_SPECIALIZE(5)
+ENGINE_SPECIALIZE(6)
+ENGINE_SPECIALIZE(7)
+ENGINE_SPECIALIZE(8)
+ENGINE_SPECIALIZE(9)
+ENGINE_SPECIALIZE(10)
+ENGINE_SPECIALIZE(11)
+ENGINE_SPECIALIZE(12)
+
+// One jump per call on the room's fixed length; each case inlines its
+// specialization, so nothing below the switch depends on len at runtime
+#define ENGINE_DISPATCH(len, call)                                     \
+    switch (len) {                                                      \
+    case 4:  call(4);  break;                                           \
+    case 5:  call(5);  break;                                           \
+    case 6:  call(6);  break;                                           \
+    case 7:  call(7);  break;                                           \
+    case 8:  call(8);  break;                                           \
+    case 9:  call(9);  break;                                           \
+    case 10: call(10); break;                                           \
+    case 11: call(11); break;                                           \
+    default: call(12); break;                                           \
+    }
+
+int engine_new_game(engine_game_t *g, const char *secret, int len) {
+    if (!engine_len_supported(len)) return -1;
+    g->len = len;
+    g->pos = 0;
+    g->pass = 0;
+    g->turn = 1;
+    g->revealed = 0;
+    g->over = secret ? 0 : 1;
+    g->score[0] = g->score[1] = g->score[2] = 0;
+#define NEW_GAME_N(N) new_game_##N(g, secret)
+    ENGINE_DISPATCH(len, NEW_GAME_N)
+#undef NEW_GAME_N
+    return 0;
+}
+
+engine_result_t engine_apply_guess(engine_game_t *g, char letter, engine_move_t *mv) {
+    engine_result_t r;
+#define APPLY_N(N) r = apply_##N(g, letter, mv)
+    ENGINE_DISPATCH(g->len, APPLY_N)
+#undef APPLY_N
+    return r;
+}
+
+void engine_snapshot(const engine_game_t *g, engine_snapshot_t *out) {
+#define SNAPSHOT_N(N) snapshot_##N(g, out)
+    ENGINE_DISPATCH(g->len, SNAPSHOT_N)
+#undef SNAPSHOT_N
+}
+
+unsigned int engine_word_feedback(unsigned long long secret, unsigned long long guess, int len) {
+    unsigned int fb = 0;
+#define FEEDBACK_N(N) fb = word_feedback_n(secret, guess, N)
+    ENGINE_DISPATCH(len, FEEDBACK_N)
+#undef FEEDBACK_N
+    return fb;
+}
+
+unsigned int engine_apply_word(engine_game_t *g, const char *guess, engine_word_move_t *mv) {
+    unsigned int fb;
+#define APPLY_WORD_N(N) fb = apply_word_##N(g, guess, mv)
+    ENGINE_DISPATCH(g->len, APPLY_WORD_N)
+#undef APPLY_WORD_N
+    return fb;
+}
+
+const char *engine_result_name(engine_result_t r) {
+    switch (r) {
+    case ENGINE_CORRECT: return "CORRECT";
+    case ENGINE_PRESENT: return "PRESENT";
+    default:             return "ABSENT";
+    }
+}
@@ -0,0 +1,127 @@
+// engine.h - Word guessing rules engine shared by server.c and GamePrototype.cpp
+//
+// Rules: a secret of `len` letters is swept position by position,
+// guessers 1 and 2 alternating, one guess per position. A guess is CORRECT
+// (scores +1 and reveals the letter), PRESENT (letter elsewhere in the word)
+// or ABSENT. After the last position the next pass starts; the game ends when
+// every letter is revealed or after ENGINE_MAX_PASSES passes.
+//
+// Word rule variant (GUESSWORD rooms): each turn is a whole len-letter word
+// scored per position with Wordle's duplicate handling, and a guesser scores
+// +1 per position it reveals. A pass is one guess from each guesser; the
+// game ends when the word is revealed or after ENGINE_MAX_PASSES passes.
+//
+// The engine owns no memory: engine_game_t is a plain struct that may live
+// on the stack or in shared memory, and no call allocates or does I/O.
+//
+// Word lengths ENGINE_MIN_WORD_LEN..ENGINE_MAX_WORD_LEN are supported. Each
+// length is a separate compile-time specialization in engine.c; the length
+// is fixed per game and picks the specialization with one switch per call,
+// so the per-guess code has no length checks or variable-bound loops.
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ENGINE_WORD_LEN      5     // classic game / default room length
+#define ENGINE_MIN_WORD_LEN  4
+#define ENGINE_MAX_WORD_LEN  12
+#define ENGINE_MAX_PASSES 5
+#define ENGINE_ALPHABET   26
+
+// Values match the ARC_* result codes in archive.h
+typedef enum {
+    ENGINE_ABSENT  = 0,
+    ENGINE_PRESENT = 1,
+    ENGINE_CORRECT = 2
+} engine_result_t;
+
+typedef struct {
+    int len;                            // word length for this game
+    char secret[ENGINE_MAX_WORD_LEN + 1];
+    char display[ENGINE_MAX_WORD_LEN + 1];  // '_' until revealed
+    int pos;                            // 0..len-1
+    int pass;                           // 0..ENGINE_MAX_PASSES (== max once over)
+    int turn;                           // guesser to move: 1 or 2
+    int revealed;                       // letters shown in display
+    int over;
+    int score[3];                       // indexed by guesser id; [0] unused
+    // Built once by engine_new_game(): bit L set if 'A'+L is in the secret,
+    // and the result of guessing 'A'+L at each position
+    unsigned int present_mask;
+    unsigned char feedback[ENGINE_ALPHABET][ENGINE_MAX_WORD_LEN];
+} engine_game_t;
+
+// What one engine_apply_guess() did
+typedef struct {
+    int player;                         // guesser that moved
+    int pass;                           // pass/pos the guess applied to (0-based)
+    int pos;
+    char letter;
+    engine_result_t result;
+    int over;                           // game ended with this guess
+} engine_move_t;
+
+// What one engine_apply_word() did
+typedef struct {
+    int player;
+    int pass;                           // pass the guess applied to (0-based)
+    unsigned int feedback;              // ENGINE_FEEDBACK_AT() per position
+    int revealed;                       // positions this guess revealed (= points)
+    int over;
+} engine_word_move_t;
+
+// Result at position i of a packed feedback word (2 bits per position)
+#define ENGINE_FEEDBACK_AT(fb, i) ((engine_result_t)(((fb) >> (2 * (i))) & 3u))
+
+typedef struct {
+    char display[ENGINE_MAX_WORD_LEN + 1];
+    int pass;
+    int pos;
+    int turn;                           // 0 once the game is over
+    int over;
+    int score_a;
+    int score_b;
+} engine_snapshot_t;
+
+// secret: len uppercase letters, or NULL for an empty board.
+// Precomputes the feedback table, so guesses cost one lookup each.
+// Returns -1 (and leaves g untouched) if len is out of range.
+int engine_new_game(engine_game_t *g, const char *secret, int len);
+
+static inline int engine_len_supported(int len) {
+    return len >= ENGINE_MIN_WORD_LEN && len <= ENGINE_MAX_WORD_LEN;
+}
+
+// letter: 'A'..'Z' (anything else is ABSENT). Applies to g->turn; returns the
+// result (also in *mv if non-NULL)
+engine_result_t engine_apply_guess(engine_game_t *g, char letter, engine_move_t *mv);
+
+void engine_snapshot(const engine_game_t *g, engine_snapshot_t *out);
+
+// 5 bits per letter (A = 0), position 0 in the low bits; w: len letters A-Z
+static inline unsigned long long engine_pack_word(const char *w, int len) {
+    unsigned long long v = 0;
+    for (int i = 0; i < len; i++) v |= (unsigned long long)(unsigned)(w[i] - 'A') << (5 * i);
+    return v;
+}
+
+// Per-position CORRECT/PRESENT/ABSENT of a whole-word guess, both words
+// packed. A guessed letter is PRESENT only while the secret still has an
+// unmatched copy of it (CORRECT positions first, then left to right).
+// Branch-free SWAR over the packed words; cheap enough for bot inner loops.
+unsigned int engine_word_feedback(unsigned long long secret, unsigned long long guess, int len);
+
+// guess: len letters A-Z (the caller validates). Applies to g->turn.
+unsigned int engine_apply_word(engine_game_t *g, const char *guess, engine_word_move_t *mv);
+
+const char *engine_result_name(engine_result_t r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+// engine_bench.c - Single-core throughput of the rules engine
+// Build: gcc -O2 -Wall -Wextra -pedantic engine_bench.c engine.c -o engine_bench
+//
+// Usage:
+//   ./engine_bench [games] [word_len] [letter|word]
+//
+// Secrets and guess letters are generated up front so the timed loop is only
+// engine_new_game() + engine_apply_guess() until each game is over. With
+// "word" the rooms play the GUESSWORD rules: each guess is a whole word made
+// of the next len letters, scored by engine_apply_word().
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "engine.h"
+
+#define NSECRETS 4096
+#define NLETTERS 65536
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+int main(int argc, char **argv) {
+    long games = (argc > 1) ? atol(argv[1]) : 5000000L;
+    int len = (argc > 2) ? atoi(argv[2]) : ENGINE_WORD_LEN;
+    int word_rules = (argc > 3) && strcmp(argv[3], "word") == 0;
+    if (!engine_len_supported(len)) {
+        fprintf(stderr, "word_len must be %d..%d\n", ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN);
+        return 1;
+    }
+
+    static char secrets[NSECRETS][ENGINE_MAX_WORD_LEN + 1];
+    static char letters[NLETTERS];
+    uint32_t seed = 2463534242u;
+    for (int i = 0; i < NSECRETS; i++) {
+        for (int k = 0; k < len; k++) secrets[i][k] = (char)('A' + xorshift32(&seed) % 26);
+        secrets[i][len] = '\0';
+    }
+    // Skewed towards common letters so games run a realistic number of turns
+    static const char common[] = "EEEAAARRIIOOTTNNSSLCUDPMHGBFYWKVXZJQ";
+    for (int i = 0; i < NLETTERS; i++) letters[i] = common[xorshift32(&seed) % (sizeof(common) - 1)];
+
+    engine_game_t g;
+    long guesses = 0;
+    long solved = 0;
+    unsigned li = 0;
+
+    double t0 = now_sec();
+    for (long n = 0; n < games; n++) {
+        engine_new_game(&g, secrets[n & (NSECRETS - 1)], len);
+        if (word_rules) {
+            while (!g.over) {
+                li = (li + (unsigned)len) & (NLETTERS - 1);
+                if (li > NLETTERS - ENGINE_MAX_WORD_LEN) li = 0;
+                engine_apply_word(&g, &letters[li], NULL);
+                guesses++;
+            }
+        } else {
+            while (!g.over) {
+                engine_apply_guess(&g, letters[li++ & (NLETTERS - 1)], NULL);
+                guesses++;
+            }
+        }
+        solved += (g.revealed == len);
+    }
+    double secs = now_sec() - t0;
+
+    printf("rules      %s, word_len %d\n", word_rules ? "word" : "letter", len);
+    printf("games      %ld (%ld solved)\n", games, solved);
+    printf("guesses    %ld\n", guesses);
+    printf("time       %.3f s\n", secs);
+    printf("guesses/s  %.1f M\n", secs > 0 ? (double)guesses / secs / 1e6 : 0.0);
+    printf("games/s    %.1f M\n", secs > 0 ? (double)games / secs / 1e6 : 0.0);
+    return 0;
+}
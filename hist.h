@@ -0,0 +1,74 @@
+// hist.h - Log-linear latency histogram (HDR-style), header-only
+//
+// Values are nanoseconds. Below HIST_SUB every value has its own bucket;
+// above, each power of two is split into HIST_SUB equal buckets, so a
+// reported percentile is within 1/HIST_SUB (~3%) of the true value at any
+// scale, from 1 ns to hours, in a fixed array of counters. Recording is a
+// count-leading-zeros and an increment: no allocation, no sorting, cheap
+// enough to stay on in every client.
+
+#ifndef HIST_H
+#define HIST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define HIST_SUB_BITS 5
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_MAGS 42                    // values past 2^47 ns (~39 h) share the top bucket
+#define HIST_BUCKETS ((HIST_MAGS + 1) * HIST_SUB)
+
+typedef struct {
+    uint64_t count;
+    uint64_t max;
+    uint64_t b[HIST_BUCKETS];
+} hist_t;
+
+static inline int hist_index(uint64_t v) {
+    if (v < HIST_SUB) return (int)v;
+    int shift = 63 - __builtin_clzll(v) - HIST_SUB_BITS;
+    int i = (shift + 1) * HIST_SUB + (int)((v >> shift) - HIST_SUB);
+    return i < HIST_BUCKETS ? i : HIST_BUCKETS - 1;
+}
+
+// Largest value that lands in bucket i
+static inline uint64_t hist_bucket_high(int i) {
+    if (i < HIST_SUB) return (uint64_t)i;
+    int shift = i / HIST_SUB - 1;
+    uint64_t low = (uint64_t)(HIST_SUB + i % HIST_SUB) << shift;
+    return low + ((uint64_t)1 << shift) - 1;
+}
+
+static inline void hist_record(hist_t *h, uint64_t v) {
+    h->b[hist_index(v)]++;
+    h->count++;
+    if (v > h->max) h->max = v;
+}
+
+// q in [0, 1]: the value at or below which q of the samples fall (bucket
+// upper bound, never above the recorded max); 0 if empty
+static inline uint64_t hist_percentile(const hist_t *h, double q) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->b[i];
+        if (seen >= rank) {
+            uint64_t v = hist_bucket_high(i);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+// "label: n=... p50=... p90=... p99=... max=... ms" (no newline)
+static inline void hist_format(char *out, size_t cap, const char *label, const hist_t *h) {
+    snprintf(out, cap, "%s: n=%llu p50=%.3f p90=%.3f p99=%.3f max=%.3f ms", label,
+             (unsigned long long)h->count,
+             (double)hist_percentile(h, 0.50) / 1e6, (double)hist_percentile(h, 0.90) / 1e6,
+             (double)hist_percentile(h, 0.99) / 1e6, (double)h->max / 1e6);
+}
+
+#endif
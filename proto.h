@@ -0,0 +1,149 @@
+// proto.h - One-pass parser for the server's key=value lines
+//
+// STATE, YOUR_TURN, ROLE and GAME_OVER lines are a command word followed by
+// space-separated key=value tokens. proto_parse() walks the line once and
+// fills a proto_line_t slot for every known key: a pointer and length into
+// the caller's line (nothing is copied and the line is not modified) plus,
+// for every field, the number atoi() would read from the value, so numeric
+// fields need no second pass.
+//
+// Same answers as looking each key up with strstr() and reading the value
+// up to the next space, with two deliberate differences: a key matches only
+// a whole token ("pos=" is never found inside "next_pos="), and a numeric
+// value ends at its token (atoi() would skip a space after an empty value
+// and read the next token). The first occurrence of a repeated key wins.
+
+#ifndef PROTO_H
+#define PROTO_H
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+enum {
+    PROTO_FROM,
+    PROTO_PASS,                     // "1/5" reads as 1; value still has "/5"
+    PROTO_POS,
+    PROTO_GUESS,
+    PROTO_RESULT,
+    PROTO_DISPLAY,
+    PROTO_SCORE_A,
+    PROTO_SCORE_B,
+    PROTO_NEXT_PASS,
+    PROTO_NEXT_POS,
+    PROTO_TURN,
+    PROTO_GUESSWORD,
+    PROTO_FEEDBACK,
+    PROTO_LEN,
+    PROTO_RULES,
+    PROTO_WORD,
+    PROTO_PASSES,
+    PROTO_WINNER,
+    PROTO_NFIELDS
+};
+
+typedef struct {
+    const char *p;                  // value start, inside the parsed line
+    int len;                        // bytes up to the next space or NUL
+    int num;                        // atoi() of the value
+} proto_val_t;
+
+typedef struct {
+    uint32_t has;                   // bit PROTO_* set if the key was seen
+    proto_val_t f[PROTO_NFIELDS];
+} proto_line_t;
+
+static inline int proto_key(const char *k, int n) {
+    switch (n) {
+    case 3:
+        if (!memcmp(k, "pos", 3)) return PROTO_POS;
+        if (!memcmp(k, "len", 3)) return PROTO_LEN;
+        break;
+    case 4:
+        if (!memcmp(k, "from", 4)) return PROTO_FROM;
+        if (!memcmp(k, "pass", 4)) return PROTO_PASS;
+        if (!memcmp(k, "turn", 4)) return PROTO_TURN;
+        if (!memcmp(k, "word", 4)) return PROTO_WORD;
+        break;
+    case 5:
+        if (!memcmp(k, "guess", 5)) return PROTO_GUESS;
+        if (!memcmp(k, "rules", 5)) return PROTO_RULES;
+        break;
+    case 6:
+        if (!memcmp(k, "result", 6)) return PROTO_RESULT;
+        if (!memcmp(k, "scoreA", 6)) return PROTO_SCORE_A;
+        if (!memcmp(k, "scoreB", 6)) return PROTO_SCORE_B;
+        if (!memcmp(k, "passes", 6)) return PROTO_PASSES;
+        if (!memcmp(k, "winner", 6)) return PROTO_WINNER;
+        break;
+    case 7:
+        if (!memcmp(k, "display", 7)) return PROTO_DISPLAY;
+        break;
+    case 8:
+        if (!memcmp(k, "next_pos", 8)) return PROTO_NEXT_POS;
+        if (!memcmp(k, "feedback", 8)) return PROTO_FEEDBACK;
+        break;
+    case 9:
+        if (!memcmp(k, "next_pass", 9)) return PROTO_NEXT_PASS;
+        if (!memcmp(k, "guessword", 9)) return PROTO_GUESSWORD;
+        break;
+    }
+    return -1;
+}
+
+// atoi() within one value: leading whitespace other than the separator,
+// sign, digits; out-of-range values saturate like strtol() before the int
+// conversion, as glibc's atoi() does
+static inline int proto_atoi(const char *p, const char *end) {
+    while (p < end && (*p == '\t' || *p == '\n' || *p == '\v' || *p == '\f' || *p == '\r')) p++;
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    unsigned long long v = 0;
+    int over = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (v > (unsigned long long)LONG_MAX / 10) over = 1;    // next digit passes LONG_MAX + 1
+        else v = v * 10 + (unsigned)(*p - '0');
+    }
+    long l;
+    if (neg) l = (over || v > (unsigned long long)LONG_MAX + 1) ? LONG_MIN : (long)(0 - v);
+    else l = (over || v > (unsigned long long)LONG_MAX) ? LONG_MAX : (long)v;
+    return (int)l;
+}
+
+// line: NUL-terminated; out points into it until the line buffer is reused
+static inline void proto_parse(const char *line, proto_line_t *out) {
+    out->has = 0;
+    const char *p = line;
+    for (;;) {
+        while (*p == ' ') p++;
+        if (!*p) return;
+        const char *tok = p;
+        while (*p != '=' && *p != ' ' && *p) p++;
+        if (*p != '=') continue;
+        const char *v = ++p;
+        while (*p != ' ' && *p) p++;
+        int k = proto_key(tok, (int)(v - 1 - tok));
+        if (k < 0 || ((out->has >> k) & 1u)) continue;
+        out->has |= 1u << k;
+        out->f[k].p = v;
+        out->f[k].len = (int)(p - v);
+        out->f[k].num = proto_atoi(v, p);
+    }
+}
+
+static inline int proto_has(const proto_line_t *l, int k) {
+    return (int)((l->has >> k) & 1u);
+}
+
+// Value of k (present) equals the string s exactly
+static inline int proto_eq(const proto_line_t *l, int k, const char *s) {
+    size_t n = strlen(s);
+    return proto_has(l, k) && (size_t)l->f[k].len == n && memcmp(l->f[k].p, s, n) == 0;
+}
+
+// Numeric value of k, or dflt if the line had no such key
+static inline int proto_int(const proto_line_t *l, int k, int dflt) {
+    return proto_has(l, k) ? l->f[k].num : dflt;
+}
+
+#endif
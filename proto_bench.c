@@ -0,0 +1,385 @@
+// proto_bench.c - proto.h against the client's old strstr() field lookups
+// Build: make proto_bench   (gcc -O2 -Wall -Wextra -pedantic proto_bench.c -o proto_bench)
+//
+// Usage:
+//   ./proto_bench [-n lines] [-r rounds] [-s seed] [-i corpus] [-o corpus]
+//     -n   generated lines (default 200000)
+//     -r   timed passes over the corpus (default 20)
+//     -i   read the corpus from a file (one line each) instead of generating
+//     -o   also write the corpus used to a file
+//
+// The corpus is real STATE (letter and word rules), YOUR_TURN and ROLE lines
+// plus fuzzed copies: fields dropped, duplicated or swapped, values empty,
+// overlong or junk, unknown tokens, truncation and flipped bytes.
+//
+// Check: for every line and key, proto_parse() must agree with the strstr()
+// lookup on presence, the value up to the next space and its atoi(). The two
+// documented differences (proto.h) are counted, not failed: a strstr() hit
+// inside a longer key ("pos=" in "next_pos="), and atoi() running past an
+// empty value into the next token. Any other difference exits 2.
+//
+// Timing: the old handle_state_line() extraction (one strstr() per field,
+// atoi()/copy) against one proto_parse() reading the same fields.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "proto.h"
+
+#define LINE_MAX_LEN 512
+
+static const char *const key_names[PROTO_NFIELDS] = {
+    "from", "pass", "pos", "guess", "result", "display", "scoreA", "scoreB",
+    "next_pass", "next_pos", "turn", "guessword", "feedback", "len", "rules",
+    "word", "passes", "winner"
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+// ---------- Corpus ----------
+
+static void random_word(uint32_t *rng, char *w, int len) {
+    for (int i = 0; i < len; i++) w[i] = (char)('A' + xorshift32(rng) % 26);
+    w[len] = '\0';
+}
+
+static void base_line(uint32_t *rng, char *out, size_t cap) {
+    static const char *const results[] = { "CORRECT", "PRESENT", "ABSENT" };
+    int len = 4 + (int)(xorshift32(rng) % 9);
+    char w[16], d[16], fb[16];
+    random_word(rng, w, len);
+    for (int i = 0; i < len; i++) {
+        uint32_t r = xorshift32(rng) % 3;
+        d[i] = r ? '_' : w[i];
+        fb[i] = "CPA"[r];
+    }
+    d[len] = fb[len] = '\0';
+    int pass = 1 + (int)(xorshift32(rng) % 5), pos = 1 + (int)(xorshift32(rng) % (unsigned)len);
+    int turn = 1 + (int)(xorshift32(rng) % 2);
+    int sa = (int)(xorshift32(rng) % 13), sb = (int)(xorshift32(rng) % 13);
+
+    switch (xorshift32(rng) % 5) {
+    case 0:
+    case 1:
+        snprintf(out, cap, "STATE from=%d pass=%d/5 pos=%d guess=%c result=%s display=%s scoreA=%d scoreB=%d next_pass=%d/5 next_pos=%d turn=%d",
+                 3 - turn, pass, pos, w[0], results[xorshift32(rng) % 3], d, sa, sb, pass, pos % len + 1, turn);
+        break;
+    case 2:
+        snprintf(out, cap, "STATE from=%d pass=%d/5 guessword=%s feedback=%s display=%s scoreA=%d scoreB=%d next_pass=%d/5 turn=%d",
+                 3 - turn, pass, w, fb, d, sa, sb, pass, turn);
+        break;
+    case 3:
+        snprintf(out, cap, "YOUR_TURN pass=%d/5 pos=%d display=%s", pass, pos, d);
+        break;
+    default:
+        snprintf(out, cap, "ROLE GUESSER%d len=%d%s", turn, len, (xorshift32(rng) & 1) ? " rules=word" : "");
+        break;
+    }
+}
+
+// Splits s into tokens in place; returns the count
+static int split_tokens(char *s, char **tok, int max) {
+    int n = 0;
+    for (char *p = strtok(s, " "); p && n < max; p = strtok(NULL, " ")) tok[n++] = p;
+    return n;
+}
+
+static void mutate_line(uint32_t *rng, char *line, size_t cap) {
+    static const char *const junk[] = {
+        "", "-", "+7", "-3", "0x1F", "99999999999999999999", "-99999999999999999999",
+        "12abc", "\t4", "=", "a=b", "next_", "_____________________________________"
+    };
+    static const char *const extra[] = {
+        "foo=1", "pos", "=5", "xpos=9", "pass_=2", "turn==3", "next_turn=4", "word=", "rules=words"
+    };
+    char tmp[LINE_MAX_LEN];
+    char *tok[64];
+    snprintf(tmp, sizeof(tmp), "%s", line);
+    int n = split_tokens(tmp, tok, 64);
+    if (n == 0) return;
+
+    char vals[8][LINE_MAX_LEN];
+    int nv = 0;
+    int edits = 1 + (int)(xorshift32(rng) % 3);
+    for (int e = 0; e < edits; e++) {
+        int i = (int)(xorshift32(rng) % (unsigned)n);
+        switch (xorshift32(rng) % 6) {
+        case 0:                                 // drop a field
+            if (n > 1) { memmove(&tok[i], &tok[i + 1], (size_t)(n - i - 1) * sizeof(char*)); n--; }
+            break;
+        case 1:                                 // duplicate one
+            if (n < 63) { memmove(&tok[i + 1], &tok[i], (size_t)(n - i) * sizeof(char*)); n++; }
+            break;
+        case 2: {                               // swap two
+            int j = (int)(xorshift32(rng) % (unsigned)n);
+            char *t = tok[i]; tok[i] = tok[j]; tok[j] = t;
+            break;
+        }
+        case 3: {                               // replace a value
+            char *eq = strchr(tok[i], '=');
+            if (eq && nv < 8) {
+                snprintf(vals[nv], sizeof(vals[nv]), "%.*s=%s", (int)(eq - tok[i]), tok[i],
+                         junk[xorshift32(rng) % (sizeof(junk) / sizeof(junk[0]))]);
+                tok[i] = vals[nv++];
+            }
+            break;
+        }
+        case 4:                                 // unknown or malformed token
+            if (n < 63) {
+                memmove(&tok[i + 1], &tok[i], (size_t)(n - i) * sizeof(char*));
+                tok[i] = (char*)extra[xorshift32(rng) % (sizeof(extra) / sizeof(extra[0]))];
+                n++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    size_t o = 0;
+    for (int i = 0; i < n && o < cap - 1; i++) {
+        int w = snprintf(line + o, cap - o, "%s%s", i ? ((xorshift32(rng) % 8) ? " " : "  ") : "", tok[i]);
+        if (w < 0) break;
+        o += (size_t)w;
+        if (o >= cap) o = cap - 1;
+    }
+    line[o] = '\0';
+
+    uint32_t r = xorshift32(rng) % 8;
+    size_t len = strlen(line);
+    if (r == 0 && len > 1) {
+        line[xorshift32(rng) % len] = '\0';     // truncated read
+    } else if (r == 1 && len > 0) {
+        char c = (char)(1 + xorshift32(rng) % 255);
+        if (c != '\n') line[xorshift32(rng) % len] = c;
+    }
+}
+
+static char **generate_corpus(int n, uint32_t seed) {
+    char **lines = malloc((size_t)n * sizeof(char*));
+    if (!lines) return NULL;
+    uint32_t rng = seed ? seed : 1;
+    char buf[LINE_MAX_LEN];
+    for (int i = 0; i < n; i++) {
+        base_line(&rng, buf, sizeof(buf));
+        if (xorshift32(&rng) % 4 != 0) mutate_line(&rng, buf, sizeof(buf));
+        lines[i] = strdup(buf);
+        if (!lines[i]) return NULL;
+    }
+    return lines;
+}
+
+static char **load_corpus(const char *path, int *n_out) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return NULL; }
+    int cap = 1024, n = 0;
+    char **lines = malloc((size_t)cap * sizeof(char*));
+    char buf[LINE_MAX_LEN];
+    while (lines && fgets(buf, sizeof(buf), f)) {
+        buf[strcspn(buf, "\r\n")] = '\0';
+        if (n == cap) {
+            cap *= 2;
+            char **grown = realloc(lines, (size_t)cap * sizeof(char*));
+            if (!grown) { free(lines); lines = NULL; break; }
+            lines = grown;
+        }
+        lines[n++] = strdup(buf);
+    }
+    fclose(f);
+    *n_out = n;
+    return lines;
+}
+
+// ---------- Equivalence check ----------
+
+typedef struct {
+    long lines;
+    long fields;
+    long inner_hits;                    // strstr() found the key inside a longer key
+    long atoi_overrun;                  // atoi() read past an empty value
+    long mismatches;
+} check_t;
+
+// First "key=" that starts a token
+static const char *find_token(const char *line, const char *pat) {
+    for (const char *p = strstr(line, pat); p; p = strstr(p + 1, pat)) {
+        if (p == line || p[-1] == ' ') return p;
+    }
+    return NULL;
+}
+
+static void check_line(const char *line, check_t *c) {
+    proto_line_t f;
+    proto_parse(line, &f);
+    c->lines++;
+
+    for (int k = 0; k < PROTO_NFIELDS; k++) {
+        char pat[16];
+        int plen = snprintf(pat, sizeof(pat), "%s=", key_names[k]);
+        const char *raw = strstr(line, pat);
+        const char *p = find_token(line, pat);
+        if (raw != p) c->inner_hits++;
+
+        int bad = (p != NULL) != proto_has(&f, k);
+        if (p && !bad) {
+            const char *v = p + plen;
+            int vlen = (int)strcspn(v, " ");
+            char val[LINE_MAX_LEN];
+            memcpy(val, v, (size_t)vlen);
+            val[vlen] = '\0';
+            if (atoi(v) != atoi(val)) c->atoi_overrun++;
+
+            const proto_val_t *pv = &f.f[k];
+            bad = pv->p != v || pv->len != vlen || pv->num != atoi(val);
+            c->fields++;
+        }
+        if (bad) {
+            if (c->mismatches < 10) fprintf(stderr, "mismatch on %s: \"%s\"\n", key_names[k], line);
+            c->mismatches++;
+        }
+    }
+}
+
+// ---------- Timing ----------
+
+// The old handle_state_line() extraction, field by field (result= was
+// read twice there too)
+static unsigned legacy_state(const char *line) {
+    int pass = 1, pos = 1, next_pass = 1, next_pos = 1, turn = 0, sa = 0, sb = 0;
+    char guess = '?';
+    char result[16] = "";
+    char disp[32] = "";
+    const char *p;
+
+    p = strstr(line, "result=");
+    if (p) {
+        p += 7;
+        int i = 0;
+        while (p[i] && p[i] != ' ' && i < 15) { result[i] = p[i]; i++; }
+        result[i] = '\0';
+    }
+    p = strstr(line, "display=");
+    if (p) {
+        p += 8;
+        int i = 0;
+        while (p[i] && p[i] != ' ' && i < 31) { disp[i] = p[i]; i++; }
+        disp[i] = '\0';
+    }
+    p = strstr(line, "pass=");
+    if (p) pass = atoi(p + 5);
+    p = strstr(line, "pos=");
+    if (p) pos = atoi(p + 4);
+    p = strstr(line, "guess=");
+    if (p) guess = p[6];
+    p = strstr(line, "result=");
+    if (p) {
+        p += 7;
+        int i = 0;
+        while (p[i] && p[i] != ' ' && i < 15) { result[i] = p[i]; i++; }
+        result[i] = '\0';
+    }
+    p = strstr(line, "scoreA=");
+    if (p) sa = atoi(p + 7);
+    p = strstr(line, "scoreB=");
+    if (p) sb = atoi(p + 7);
+    p = strstr(line, "next_pass=");
+    if (p) next_pass = atoi(p + 10);
+    p = strstr(line, "next_pos=");
+    if (p) next_pos = atoi(p + 9);
+    p = strstr(line, "turn=");
+    if (p) turn = atoi(p + 5);
+
+    return (unsigned)(pass + pos * 3 + next_pass * 5 + next_pos * 7 + turn * 11 + sa + sb)
+         ^ (unsigned char)guess ^ (unsigned char)result[0] ^ (unsigned char)disp[0];
+}
+
+static unsigned proto_state(const char *line) {
+    proto_line_t f;
+    proto_parse(line, &f);
+    int pass = proto_int(&f, PROTO_PASS, 1), pos = proto_int(&f, PROTO_POS, 1);
+    int next_pass = proto_int(&f, PROTO_NEXT_PASS, 1), next_pos = proto_int(&f, PROTO_NEXT_POS, 1);
+    int turn = proto_int(&f, PROTO_TURN, 0);
+    int sa = proto_int(&f, PROTO_SCORE_A, 0), sb = proto_int(&f, PROTO_SCORE_B, 0);
+    char guess = proto_has(&f, PROTO_GUESS) ? f.f[PROTO_GUESS].p[0] : '?';
+    char r0 = (proto_has(&f, PROTO_RESULT) && f.f[PROTO_RESULT].len) ? f.f[PROTO_RESULT].p[0] : '\0';
+    char d0 = (proto_has(&f, PROTO_DISPLAY) && f.f[PROTO_DISPLAY].len) ? f.f[PROTO_DISPLAY].p[0] : '\0';
+
+    return (unsigned)(pass + pos * 3 + next_pass * 5 + next_pos * 7 + turn * 11 + sa + sb)
+         ^ (unsigned char)guess ^ (unsigned char)r0 ^ (unsigned char)d0;
+}
+
+static double time_parser(unsigned (*fn)(const char*), char **lines, int n, int rounds, unsigned *sink) {
+    double t0 = now_sec();
+    unsigned acc = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) acc += fn(lines[i]);
+    }
+    *sink += acc;
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv) {
+    int n = 200000, rounds = 20;
+    uint32_t seed = 12345;
+    const char *in_path = NULL, *out_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:s:i:o:")) != -1) {
+        switch (opt) {
+        case 'n': n = atoi(optarg); break;
+        case 'r': rounds = atoi(optarg); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+        case 'i': in_path = optarg; break;
+        case 'o': out_path = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n lines] [-r rounds] [-s seed] [-i corpus] [-o corpus]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1) n = 1;
+    if (rounds < 1) rounds = 1;
+
+    char **lines = in_path ? load_corpus(in_path, &n) : generate_corpus(n, seed);
+    if (!lines || n == 0) {
+        fprintf(stderr, "Empty corpus.\n");
+        return 1;
+    }
+    if (out_path) {
+        FILE *f = fopen(out_path, "w");
+        if (!f) { perror(out_path); return 1; }
+        for (int i = 0; i < n; i++) fprintf(f, "%s\n", lines[i]);
+        fclose(f);
+    }
+
+    check_t c;
+    memset(&c, 0, sizeof(c));
+    for (int i = 0; i < n; i++) check_line(lines[i], &c);
+    printf("check: %ld lines, %ld fields agree; documented differences: %ld inner-key hits, %ld atoi overruns; %ld mismatches\n",
+           c.lines, c.fields, c.inner_hits, c.atoi_overrun, c.mismatches);
+
+    unsigned sink = 0;
+    time_parser(legacy_state, lines, n, 1, &sink);     // warm caches
+    double tl = time_parser(legacy_state, lines, n, rounds, &sink);
+    double tp = time_parser(proto_state, lines, n, rounds, &sink);
+    double per = (double)n * rounds;
+    printf("strstr:      %6.1f ns/line\n", tl * 1e9 / per);
+    printf("proto_parse: %6.1f ns/line  (%.2fx)   [sink %u]\n", tp * 1e9 / per, tp > 0 ? tl / tp : 0.0, sink);
+
+    for (int i = 0; i < n; i++) free(lines[i]);
+    free(lines);
+    return c.mismatches ? 2 : 0;
+}
@@ -0,0 +1,99 @@
+// rank.h - Word difficulty index (rank.idx), mmapped read-only
+//
+// Built offline by wordrank, which plays the info bot (bot.h) against every
+// dictionary word with many seeds. One section per word length, like
+// dict.idx; each is an array of fixed-size records sorted easiest first
+// (fewest expected guesses to the end of the game), so a difficulty bucket
+// is just a slice of it and the server needs no parsing or sorting.
+
+#ifndef RANK_H
+#define RANK_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dict.h"
+
+#define RANK_MAGIC 0x314b4e52u      // "RNK1"
+
+typedef struct {
+    uint64_t key;                   // dict_pack() of the word
+    float mean_guesses;             // guesses both bots played until the game ended
+    uint8_t solve_pct;              // games that revealed the whole word, 0..100
+    uint8_t end_pass;               // most common pass (1-based) the game ended in
+    uint8_t win_a_pct;              // games the first guesser won, 0..100
+    uint8_t reserved;
+} rank_rec_t;
+
+typedef struct {
+    uint64_t offset;                // from start of file, 8-byte aligned
+    uint64_t count;                 // records (0: length not ranked)
+} rank_section_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seeds;                 // games played per word
+    rank_section_t sec[DICT_MAX_LEN + 1];   // indexed by word length
+} rank_header_t;
+
+typedef struct {
+    const rank_header_t *hdr;
+    const uint8_t *base;
+    size_t map_len;
+} rank_t;
+
+_Static_assert(sizeof(rank_rec_t) == 16, "rank_rec_t layout changed");
+_Static_assert(sizeof(rank_header_t) % 8 == 0, "sections must stay 8-byte aligned");
+
+static inline int rank_open(rank_t *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(rank_header_t)) {
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    // Bounds checked without offset + count * size, which a huge count wraps
+    const rank_header_t *h = (const rank_header_t*)map;
+    uint64_t size = (uint64_t)st.st_size;
+    int ok = (h->magic == RANK_MAGIC);
+    for (int len = 0; ok && len <= DICT_MAX_LEN; len++) {
+        const rank_section_t *s = &h->sec[len];
+        if (s->count && (s->offset % 8 || s->offset > size ||
+                         s->count > (size - s->offset) / sizeof(rank_rec_t))) ok = 0;
+    }
+    if (!ok) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    r->hdr = h;
+    r->base = (const uint8_t*)map;
+    r->map_len = (size_t)st.st_size;
+    return 0;
+}
+
+static inline void rank_close(rank_t *r) {
+    if (r->hdr) munmap((void*)r->base, r->map_len);
+    memset(r, 0, sizeof(*r));
+}
+
+// Records for this length, easiest first; *n = 0 (and NULL) if not ranked
+static inline const rank_rec_t *rank_section(const rank_t *r, int len, uint64_t *n) {
+    *n = 0;
+    if (!r->hdr || len < 0 || len > DICT_MAX_LEN || r->hdr->sec[len].count == 0) return NULL;
+    *n = r->hdr->sec[len].count;
+    return (const rank_rec_t*)(r->base + r->hdr->sec[len].offset);
+}
+
+#endif
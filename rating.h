@@ -0,0 +1,23 @@
+// rating.h - Elo rating update shared by the server and the rerate tool
+//
+// The server applies one update per finished game (O(1), under the two score
+// stripe locks scores_record_game takes); rerate replays the logged history
+// from scratch with the same formula.
+
+#ifndef RATING_H
+#define RATING_H
+
+#include <math.h>
+
+#define RATING_INITIAL 1500.0
+#define RATING_K       32.0
+
+// score_a: 1.0 if A won, 0.0 if B won, 0.5 for a draw
+static inline void elo_update(double *ra, double *rb, double score_a) {
+    double expect_a = 1.0 / (1.0 + pow(10.0, (*rb - *ra) / 400.0));
+    double delta = RATING_K * (score_a - expect_a);
+    *ra += delta;
+    *rb -= delta;
+}
+
+#endif
@@ -0,0 +1,55 @@
+// rec.h - Input recording format (server --record=FILE, read by replay)
+//
+// One header, then one fixed-size event per input the game state machine
+// consumed, in the order it consumed them: events are appended while the
+// server holds game_mtx, from whichever process handled the input, with
+// O_APPEND so concurrent writers never interleave inside a record.
+// Timestamps are CLOCK_MONOTONIC milliseconds since the recording started.
+//
+// The secret (typed by a wordmaster or drawn by --auto) and every guess are
+// stored, so a replay needs no seed and no timing to reproduce the games;
+// GUESS/GUESSWORD also carry the result the server answered and END the final
+// scores, which replay checks against its own run of the engine.
+
+#ifndef REC_H
+#define REC_H
+
+#include <stdint.h>
+
+#include "engine.h"
+
+#define REC_MAGIC 0x31434552u       // "REC1"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t word_len;              // fixed for the room's lifetime
+    uint64_t seed;                  // --auto word draw seed (informational)
+    uint64_t start_time;            // unix seconds when recording started
+} rec_header_t;
+
+enum {
+    REC_JOIN  = 1,                  // player: slot that sent NAME (or RESUME)
+    REC_LEAVE = 2,                  // player: slot that disconnected
+    REC_GAME  = 3,                  // word: the secret for the new game
+    REC_GUESS = 4,                  // player, letter, result
+    REC_END   = 5,                  // result: winner (0 draw), score_a/score_b
+    REC_ABORT = 6,                  // game ended early (a guesser left)
+    REC_GUESSWORD = 7               // --rules=word: player, word, result = positions revealed
+};
+
+typedef struct {
+    uint32_t t_ms;
+    uint8_t type;                   // REC_*
+    uint8_t player;
+    uint8_t letter;
+    uint8_t result;
+    uint8_t score_a;
+    uint8_t score_b;
+    uint8_t reserved[2];
+    char word[ENGINE_MAX_WORD_LEN]; // NUL-padded, not NUL-terminated at max length
+} rec_event_t;
+
+_Static_assert(sizeof(rec_header_t) == 24, "rec_header_t layout changed");
+_Static_assert(sizeof(rec_event_t) == 24, "rec_event_t layout changed");
+
+#endif
@@ -0,0 +1,210 @@
+// replay.c - Replay server recordings (--record=FILE) through the rules engine
+// Build: make replay   (gcc ... replay.c engine.o -o replay)
+//
+// Usage:
+//   ./replay [-r] [-x speed] [-n loops] <recording>...
+//     (default)  full speed: every event is applied back to back
+//     -r         real time: each event waits for its recorded timestamp
+//     -x speed   real time scaled by speed (-x 10 = ten times faster)
+//     -n loops   replay the whole corpus this many times (benchmarking)
+//
+// Every REC_GAME starts engine_new_game() with the recorded secret and every
+// REC_GUESS is applied with engine_apply_guess() (REC_GUESSWORD with
+// engine_apply_word() for --rules=word rooms), the same calls the server
+// makes under game_mtx. Each step is checked against the recording (whose
+// turn it was, the result the server answered, the final scores), so a
+// replay is both a deterministic regression test of the rules and, over a
+// large corpus at full speed, a repeatable benchmark. Exits 2 on mismatch.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "rec.h"
+
+typedef struct {
+    const char *path;
+    const rec_header_t *hdr;
+    const rec_event_t *ev;
+    size_t n;
+    size_t map_len;
+} recording_t;
+
+typedef struct {
+    uint64_t events;
+    uint64_t games;
+    uint64_t aborted;
+    uint64_t guesses;
+    uint64_t joins;
+    uint64_t mismatches;
+} replay_totals_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until_ns(uint64_t t) {
+    struct timespec ts = { (time_t)(t / 1000000000ull), (long)(t % 1000000000ull) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) { }
+}
+
+static int recording_open(recording_t *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    r->path = path;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror(path); return -1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(rec_header_t)) {
+        fprintf(stderr, "%s: not a recording\n", path);
+        close(fd);
+        return -1;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) { perror("mmap"); return -1; }
+
+    r->hdr = (const rec_header_t*)map;
+    r->map_len = (size_t)st.st_size;
+    if (r->hdr->magic != REC_MAGIC || !engine_len_supported((int)r->hdr->word_len)) {
+        fprintf(stderr, "%s: bad header\n", path);
+        munmap(map, r->map_len);
+        return -1;
+    }
+    r->ev = (const rec_event_t*)(r->hdr + 1);
+    r->n = (r->map_len - sizeof(rec_header_t)) / sizeof(rec_event_t);   // a torn tail is ignored
+    return 0;
+}
+
+static void mismatch(replay_totals_t *t, const recording_t *r, size_t i, const char *what) {
+    if (t->mismatches++ < 10) {
+        fprintf(stderr, "%s: event %zu (t=%u ms): %s\n", r->path, i, r->ev[i].t_ms, what);
+    }
+}
+
+// speed 0 = full speed. base_ns: wall time that t_ms == 0 maps to.
+static void replay_one(const recording_t *r, double speed, uint64_t base_ns, replay_totals_t *t) {
+    int len = (int)r->hdr->word_len;
+    engine_game_t g;
+    engine_new_game(&g, NULL, len);
+    int in_game = 0;
+
+    for (size_t i = 0; i < r->n; i++) {
+        const rec_event_t *e = &r->ev[i];
+        if (speed > 0) sleep_until_ns(base_ns + (uint64_t)((double)e->t_ms * 1e6 / speed));
+        t->events++;
+
+        switch (e->type) {
+        case REC_JOIN:
+            t->joins++;
+            break;
+        case REC_LEAVE:
+            break;
+        case REC_GAME: {
+            if (in_game) mismatch(t, r, i, "new game before the last one ended");
+            char secret[ENGINE_MAX_WORD_LEN + 1];
+            memcpy(secret, e->word, (size_t)len);
+            secret[len] = '\0';
+            engine_new_game(&g, secret, len);
+            in_game = 1;
+            t->games++;
+            break;
+        }
+        case REC_GUESS: {
+            if (!in_game || g.over) { mismatch(t, r, i, "guess outside a game"); break; }
+            if (g.turn != e->player) mismatch(t, r, i, "guess out of turn");
+            engine_move_t mv;
+            engine_apply_guess(&g, (char)e->letter, &mv);
+            if ((int)mv.result != e->result) mismatch(t, r, i, "result differs");
+            t->guesses++;
+            break;
+        }
+        case REC_GUESSWORD: {
+            if (!in_game || g.over) { mismatch(t, r, i, "guess outside a game"); break; }
+            if (g.turn != e->player) mismatch(t, r, i, "guess out of turn");
+            char word[ENGINE_MAX_WORD_LEN + 1];
+            memcpy(word, e->word, (size_t)len);
+            word[len] = '\0';
+            engine_word_move_t mv;
+            engine_apply_word(&g, word, &mv);
+            if (mv.revealed != e->result) mismatch(t, r, i, "revealed count differs");
+            t->guesses++;
+            break;
+        }
+        case REC_END:
+            if (!g.over) mismatch(t, r, i, "recorded end, engine still playing");
+            if (g.score[1] != e->score_a || g.score[2] != e->score_b) mismatch(t, r, i, "final scores differ");
+            in_game = 0;
+            break;
+        case REC_ABORT:
+            in_game = 0;
+            t->aborted++;
+            break;
+        default:
+            mismatch(t, r, i, "unknown event type");
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    double speed = 0.0;
+    long loops = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "rx:n:")) != -1) {
+        switch (opt) {
+        case 'r': if (speed <= 0) speed = 1.0; break;
+        case 'x': speed = atof(optarg); break;
+        case 'n': loops = atol(optarg); break;
+        default: optind = argc + 1; break;
+        }
+    }
+    if (optind >= argc || loops < 1 || speed < 0) {
+        fprintf(stderr, "Usage: %s [-r] [-x speed] [-n loops] <recording>...\n", argv[0]);
+        return 1;
+    }
+
+    int nrec = argc - optind;
+    recording_t *recs = calloc((size_t)nrec, sizeof(*recs));
+    if (!recs) { perror("calloc"); return 1; }
+    for (int k = 0; k < nrec; k++) {
+        if (recording_open(&recs[k], argv[optind + k]) != 0) return 1;
+    }
+
+    replay_totals_t t;
+    memset(&t, 0, sizeof(t));
+    uint64_t t0 = now_ns();
+    uint64_t base = t0;
+    for (long l = 0; l < loops; l++) {
+        for (int k = 0; k < nrec; k++) {
+            replay_one(&recs[k], speed, base, &t);
+            // Real time: the next recording starts where this one's last event was
+            if (speed > 0 && recs[k].n) base += (uint64_t)((double)recs[k].ev[recs[k].n - 1].t_ms * 1e6 / speed);
+        }
+    }
+    double secs = (double)(now_ns() - t0) / 1e9;
+
+    printf("%d recording(s) x %ld: %llu events, %llu games (%llu aborted), %llu guesses, %llu joins\n",
+           nrec, loops, (unsigned long long)t.events, (unsigned long long)t.games,
+           (unsigned long long)t.aborted, (unsigned long long)t.guesses, (unsigned long long)t.joins);
+    printf("%s in %.3f s: %.0f events/s, %.0f games/s, %.0f guesses/s\n",
+           speed > 0 ? "real time" : "full speed", secs,
+           secs > 0 ? (double)t.events / secs : 0.0,
+           secs > 0 ? (double)t.games / secs : 0.0,
+           secs > 0 ? (double)t.guesses / secs : 0.0);
+    printf("mismatches=%llu\n", (unsigned long long)t.mismatches);
+
+    for (int k = 0; k < nrec; k++) munmap((void*)recs[k].hdr, recs[k].map_len);
+    free(recs);
+    return t.mismatches ? 2 : 0;
+}
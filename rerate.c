@@ -0,0 +1,222 @@
+// rerate.c - Offline Elo re-rating from the game history in game.log
+// Build: gcc -O2 -Wall -Wextra -pedantic -pthread rerate.c -o rerate -lm
+//
+// Usage:
+//   ./rerate [game.log] [threads]
+//
+// The log is mmapped and split into newline-aligned chunks; each thread parses
+// the "Game #N result:" lines of its chunk. Elo is order dependent, so the
+// parsed games are then folded in log order on one thread (O(1) per game).
+// Prints "rating wins games name" per player, best first.
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rating.h"
+
+#define NAME_LEN 32
+#define MAX_THREADS 64
+
+typedef struct {
+    int winner;                 // 0 draw, 1 = A, 2 = B
+    char a[NAME_LEN];
+    char b[NAME_LEN];
+} game_rec_t;
+
+typedef struct {
+    const char *begin;
+    const char *end;
+    game_rec_t *recs;
+    size_t count;
+    size_t cap;
+} chunk_t;
+
+typedef struct {
+    char name[NAME_LEN];
+    double rating;
+    int wins;
+    int games;
+    int used;
+} player_t;
+
+static player_t *g_players = NULL;
+static size_t g_players_cap = 0;
+static size_t g_players_n = 0;
+
+static uint64_t name_hash(const char *s) {
+    uint64_t h = 1469598103934665603ull;   // FNV-1a
+    while (*s) { h ^= (unsigned char)*s++; h *= 1099511628211ull; }
+    return h;
+}
+
+static player_t *player_get(const char *name);
+
+static void players_grow(void) {
+    player_t *old = g_players;
+    size_t old_cap = g_players_cap;
+    g_players_cap = old_cap ? old_cap * 2 : 1024;
+    g_players = calloc(g_players_cap, sizeof(player_t));
+    if (!g_players) { perror("calloc"); exit(1); }
+    g_players_n = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (!old[i].used) continue;
+        player_t *p = player_get(old[i].name);
+        *p = old[i];
+    }
+    free(old);
+}
+
+static player_t *player_get(const char *name) {
+    // Pure lookups never rehash; only inserting a new name may grow the table
+    if (g_players_cap) {
+        size_t mask = g_players_cap - 1;
+        size_t i = (size_t)name_hash(name) & mask;
+        while (g_players[i].used) {
+            if (strcmp(g_players[i].name, name) == 0) return &g_players[i];
+            i = (i + 1) & mask;
+        }
+    }
+    if ((g_players_n + 1) * 2 > g_players_cap) players_grow();
+
+    size_t mask = g_players_cap - 1;
+    size_t i = (size_t)name_hash(name) & mask;
+    while (g_players[i].used) i = (i + 1) & mask;
+    g_players[i].used = 1;
+    snprintf(g_players[i].name, NAME_LEN, "%s", name);
+    g_players[i].rating = RATING_INITIAL;
+    g_players_n++;
+    return &g_players[i];
+}
+
+static void chunk_push(chunk_t *c, const game_rec_t *r) {
+    if (c->count == c->cap) {
+        c->cap = c->cap ? c->cap * 2 : 256;
+        c->recs = realloc(c->recs, c->cap * sizeof(game_rec_t));
+        if (!c->recs) { perror("realloc"); exit(1); }
+    }
+    c->recs[c->count++] = *r;
+}
+
+static void *parse_chunk(void *arg) {
+    chunk_t *c = (chunk_t*)arg;
+    const char *p = c->begin;
+    while (p < c->end) {
+        const char *nl = memchr(p, '\n', (size_t)(c->end - p));
+        const char *eol = nl ? nl : c->end;
+
+        // "<ts> | Game #N result: winner=W A=<name> B=<name> (...)"
+        const char *m = memmem(p, (size_t)(eol - p), " result: winner=", 16);
+        if (m) {
+            char line[256];
+            size_t n = (size_t)(eol - m);
+            if (n >= sizeof(line)) n = sizeof(line) - 1;
+            memcpy(line, m, n);
+            line[n] = '\0';
+
+            game_rec_t r;
+            if (sscanf(line, " result: winner=%d A=%31s B=%31s", &r.winner, r.a, r.b) == 3) {
+                chunk_push(c, &r);
+            }
+        }
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+static int cmp_rating_desc(const void *x, const void *y) {
+    const player_t *a = *(const player_t* const*)x;
+    const player_t *b = *(const player_t* const*)y;
+    return (a->rating < b->rating) - (a->rating > b->rating);
+}
+
+int main(int argc, char **argv) {
+    const char *path = (argc > 1) ? argv[1] : "game.log";
+    int nthreads = (argc > 2) ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { perror("open"); return 1; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { perror("fstat"); return 1; }
+    size_t size = (size_t)st.st_size;
+    if (size == 0) { close(fd); return 0; }
+
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) { perror("mmap"); return 1; }
+    close(fd);
+
+    // Split on line boundaries
+    chunk_t chunks[MAX_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+    const char *cur = data;
+    const char *end = data + size;
+    for (int t = 0; t < nthreads; t++) {
+        const char *stop = (t == nthreads - 1) ? end : data + size * (size_t)(t + 1) / (size_t)nthreads;
+        if (stop < cur) stop = cur;
+        if (stop < end) {
+            const char *nl = memchr(stop, '\n', (size_t)(end - stop));
+            stop = nl ? nl + 1 : end;
+        }
+        chunks[t].begin = cur;
+        chunks[t].end = stop;
+        cur = stop;
+    }
+
+    pthread_t th[MAX_THREADS];
+    for (int t = 0; t < nthreads; t++) pthread_create(&th[t], NULL, parse_chunk, &chunks[t]);
+    for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+
+    // Replay in log order
+    size_t games = 0;
+    for (int t = 0; t < nthreads; t++) {
+        for (size_t i = 0; i < chunks[t].count; i++) {
+            const game_rec_t *r = &chunks[t].recs[i];
+            player_t *a = player_get(r->a);
+            player_t *b = player_get(r->b);   // may grow the table; re-fetch a
+            a = player_get(r->a);
+            games++;
+            if (a == b) {
+                // Both seats under one name: the server keeps only seat A's
+                // half of the update (and its win), so do the same
+                double rb = a->rating;
+                elo_update(&a->rating, &rb, r->winner == 1 ? 1.0 : (r->winner == 2 ? 0.0 : 0.5));
+                a->games++;
+                if (r->winner == 1) a->wins++;
+                continue;
+            }
+            elo_update(&a->rating, &b->rating,
+                       r->winner == 1 ? 1.0 : (r->winner == 2 ? 0.0 : 0.5));
+            a->games++;
+            b->games++;
+            if (r->winner == 1) a->wins++;
+            else if (r->winner == 2) b->wins++;
+        }
+        free(chunks[t].recs);
+    }
+
+    player_t **order = malloc((g_players_n + 1) * sizeof(player_t*));
+    size_t n = 0;
+    for (size_t i = 0; i < g_players_cap; i++) {
+        if (g_players[i].used) order[n++] = &g_players[i];
+    }
+    qsort(order, n, sizeof(player_t*), cmp_rating_desc);
+
+    for (size_t i = 0; i < n; i++) {
+        printf("%.1f %d %d %s\n", order[i]->rating, order[i]->wins, order[i]->games, order[i]->name);
+    }
+    fprintf(stderr, "Replayed %zu games for %zu players using %d threads.\n", games, n, nthreads);
+
+    free(order);
+    free(g_players);
+    munmap((void*)data, size);
+    return 0;
+}
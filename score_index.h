@@ -0,0 +1,153 @@
+// score_index.h - Sorted on-disk score index (scores.idx), mmapped read-only
+//
+// The index is the base copy of every player's wins/rating. Records are
+// sorted by (name hash, name), so opening it is just an mmap and a lookup is
+// a binary search over fixed-size records - no parsing at startup however
+// many players it holds. scores.txt carries only the players touched since
+// the index was last rebuilt; score_index_write_merged() folds those back in.
+
+#ifndef SCORE_INDEX_H
+#define SCORE_INDEX_H
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SCORE_IDX_MAGIC 0x31584453u   // "SDX1"
+#define SCORE_IDX_NAME_LEN 32
+
+typedef struct {
+    uint32_t magic;
+    uint32_t rec_size;
+    uint64_t count;
+} score_idx_header_t;
+
+typedef struct {
+    uint32_t hash;
+    int32_t wins;
+    int32_t slot;
+    int32_t reserved;
+    double rating;
+    char name[SCORE_IDX_NAME_LEN];
+} score_idx_rec_t;
+
+typedef struct {
+    const score_idx_rec_t *recs;
+    uint64_t count;
+    void *map;
+    size_t map_len;
+} score_index_t;
+
+static inline uint32_t score_name_hash(const char *name) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    for (const unsigned char *p = (const unsigned char*)name; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline int score_idx_cmp(uint32_t hash, const char *name, const score_idx_rec_t *r) {
+    if (hash != r->hash) return (hash < r->hash) ? -1 : 1;
+    return strncmp(name, r->name, SCORE_IDX_NAME_LEN);
+}
+
+static inline int score_idx_rec_cmp(const void *a, const void *b) {
+    const score_idx_rec_t *x = (const score_idx_rec_t*)a;
+    return score_idx_cmp(x->hash, x->name, (const score_idx_rec_t*)b);
+}
+
+// Returns 0 and an empty index when the file is missing or not an index
+static inline int score_index_open(score_index_t *ix, const char *path) {
+    memset(ix, 0, sizeof(*ix));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(score_idx_header_t)) {
+        close(fd);
+        return 0;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    const score_idx_header_t *h = (const score_idx_header_t*)map;
+    if (h->magic != SCORE_IDX_MAGIC || h->rec_size != sizeof(score_idx_rec_t) ||
+        h->count > ((size_t)st.st_size - sizeof(*h)) / sizeof(score_idx_rec_t)) {
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    ix->map = map;
+    ix->map_len = (size_t)st.st_size;
+    ix->recs = (const score_idx_rec_t*)(h + 1);
+    ix->count = h->count;
+    return 0;
+}
+
+static inline void score_index_close(score_index_t *ix) {
+    if (ix->map) munmap(ix->map, ix->map_len);
+    memset(ix, 0, sizeof(*ix));
+}
+
+static inline const score_idx_rec_t *score_index_find(const score_index_t *ix, const char *name) {
+    uint32_t hash = score_name_hash(name);
+    uint64_t lo = 0, hi = ix->count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        int c = score_idx_cmp(hash, name, &ix->recs[mid]);
+        if (c == 0) return &ix->recs[mid];
+        if (c < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+// Writes path as old + fresh (fresh wins on equal names). fresh is sorted in
+// place. Written to path.tmp and renamed, so existing mappings stay valid.
+static inline int score_index_write_merged(const char *path, const score_index_t *old,
+                                           score_idx_rec_t *fresh, size_t n_fresh) {
+    qsort(fresh, n_fresh, sizeof(*fresh), score_idx_rec_cmp);
+
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return -1;
+    setvbuf(f, NULL, _IOFBF, 1 << 20);
+
+    score_idx_header_t h = { SCORE_IDX_MAGIC, sizeof(score_idx_rec_t), 0 };
+    fwrite(&h, sizeof(h), 1, f);
+
+    uint64_t i = 0, n_old = old ? old->count : 0;
+    size_t j = 0;
+    while (i < n_old || j < n_fresh) {
+        const score_idx_rec_t *r;
+        if (j >= n_fresh) r = &old->recs[i++];
+        else if (i >= n_old) r = &fresh[j++];
+        else {
+            int c = score_idx_rec_cmp(&fresh[j], &old->recs[i]);
+            if (c < 0) r = &fresh[j++];
+            else if (c > 0) r = &old->recs[i++];
+            else { r = &fresh[j++]; i++; }
+        }
+        fwrite(r, sizeof(*r), 1, f);
+        h.count++;
+    }
+
+    fseek(f, 0, SEEK_SET);
+    fwrite(&h, sizeof(h), 1, f);
+    int err = ferror(f);
+    if (fclose(f) != 0) err = 1;
+    if (err) return -1;
+    return rename(tmp, path);
+}
+
+#endif
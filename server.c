@@ -1,18 +1,32 @@
 // server.c - Concurrent Networked Word Guessing Game (3 players)
 // Architecture:
-// - Parent: accept() loop, forks 3 children (1 per client), runs 2 threads:
+// - Parent: accept() loop, forks 1 child per connection, runs 3 threads:
 //   (1) scheduler thread (RR turns for guessers) (2) logger thread (non-blocking queue -> game.log)
+//   (3) score loader (applies scores.txt over the mmapped scores.idx after listen())
 // - Shared state: POSIX shared memory, process-shared mutexes + semaphores
 // - Communication: TCP IPv4 sockets
 //
-// Build: gcc -O2 -Wall -Wextra -pedantic -pthread server.c -o server
+// Build: make server   (gcc ... server.c engine.o -o server -lm)
 //
 // Notes:
 // - This is a skeleton meant to satisfy OS-core requirements first.
-// - Game: 5-letter word. Positions 0..4. Each position: guesser1 turn then guesser2 turn.
-//   Score +1 if guessed letter matches the secret word at that position.
-//   After position 4 completes, game ends; winner is higher score; tie = draw.
+// - Game: N-letter word (N = 4..12 per room, default 5), swept position by
+//   position with guesser1 and guesser2 alternating. Score +1 if the guessed
+//   letter matches the secret word at that position. The game ends when the
+//   word is revealed or after the last pass (ENGINE_MAX_PASSES, engine.h);
+//   winner is higher score; tie = draw.
 //   Server then requests a new word from wordmaster (multi-game without restart).
+// - With --auto the server is the wordmaster: only 2 guessers connect and each
+//   secret is drawn from dict.idx by difficulty bucket, games back-to-back.
+//   Buckets follow rank.idx (see wordrank) when it is present.
+// - With --record=FILE every input (secrets, guesses, joins) is logged with a
+//   timestamp for the replay tool; --seed=N makes --auto draws repeatable.
+// - With --rules=word each turn is a whole dictionary word (GUESSWORD) scored
+//   per position, Wordle style; see engine.h for the variant's rules.
+// - NAME returns a SESSION token; a dropped player's slot is held for
+//   --grace=SEC (default 30) and RESUME <token> reconnects into it.
+// - A client may ask for binary frames instead of text lines (wire.h);
+//   STATE, YOUR_TURN, GAME_OVER and ROLE then go out as fixed-layout structs.
 
 #define _GNU_SOURCE
 #include <arpa/inet.h>
@@ -24,6 +38,7 @@
 #include <signal.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -35,8 +50,18 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "archive.h"
+#include "dict.h"
+#include "engine.h"
+#include "rank.h"
+#include "rating.h"
+#include "rec.h"
+#include "score_index.h"
+#include "wire.h"
+
 #define MAX_PLAYERS 3
-#define WORD_LEN 5
+#define WORD_LEN ENGINE_WORD_LEN          // default room word length
+#define MAX_WORD_LEN ENGINE_MAX_WORD_LEN  // sizes every per-position array
 #define NAME_LEN 32
 
 #define SHM_NAME "/csn6214_wordgame_shm_v1"
@@ -46,6 +71,25 @@
 
 #define OUTQ_CAP 256
 #define OUT_MSG_LEN 256
+// Every queued handle holds a buffer, plus one per publisher still fanning out
+#define OUT_POOL_CAP (MAX_PLAYERS * (OUTQ_CAP + 2))
+
+#define SCORE_STRIPES 64          // power of two; stripe = name hash & (SCORE_STRIPES - 1)
+#define SCORE_STRIPE_CAP 256      // power of two; open-addressed slots per stripe
+#define SCORES_TXT "scores.txt"   // players touched since the index was rebuilt
+#define SCORES_IDX "scores.idx"   // sorted base store, see score_index.h
+
+#define STATS_CAP 65536           // players in stats.col; ~10 MB of shm, pages touched only as rows fill
+#define STATS_HASH_CAP (2 * STATS_CAP)  // power of two; name -> column index, half full at most
+#define STATS_PATH "stats.col"
+#define STATS_MAGIC 0x31435453u   // "STC1"
+#define STATS_FLUSH_EVERY 4       // games between merges reaching disk
+
+#define DICT_PATH "dict.idx"      // built by dictbuild; optional
+#define RANK_PATH "rank.idx"      // built by wordrank; optional, orders --auto buckets
+#define ARCHIVE_PATH "games.arc"  // one arc_game_t per completed game, see archive.h
+
+#define AUTO_BUCKETS 3            // --auto difficulty buckets: easy, medium, hard
 
 typedef enum {
     PHASE_WAITING_PLAYERS = 0,
@@ -55,14 +99,71 @@ typedef enum {
 } game_phase_t;
 
 typedef struct {
-    char name[NAME_LEN];
+    int present;                   // 0 = entry did not exist (snapshot pre-images only)
     int wins;
+    double rating;
+    int slot;                      // player slot of the last game (kept in scores.txt)
+} score_value_t;
+
+typedef struct {
+    char name[NAME_LEN];
+    int used;
+    score_value_t val;
+    // Copy-on-write pre-image for the snapshot taken at epoch snap_epoch
+    uint32_t snap_epoch;
+    score_value_t snap;
 } score_entry_t;
 
+// One lock per stripe; games only contend when their players hash to the same stripe
+typedef struct {
+    pthread_mutex_t mtx;           // process-shared
+    int count;
+    score_entry_t slots[SCORE_STRIPE_CAP];
+} score_stripe_t;
+
+// Per-player counters accumulated by a room while games are played
+typedef struct {
+    uint32_t guesses;
+    uint32_t correct;
+    uint32_t present;
+    uint32_t absent;
+    uint64_t think_ms;                 // sum of YOUR_TURN -> GUESS delays
+    uint32_t pos_guesses[MAX_WORD_LEN];
+    uint32_t pos_correct[MAX_WORD_LEN];
+} room_stats_t;
+
+// Lifetime statistics, stored column by column so each counter can be scanned
+// as one contiguous array (same layout as stats.col on disk)
+typedef struct {
+    int count;
+    char name[STATS_CAP][NAME_LEN];
+    uint32_t games[STATS_CAP];
+    uint32_t guesses[STATS_CAP];
+    uint32_t correct[STATS_CAP];
+    uint32_t present[STATS_CAP];
+    uint32_t absent[STATS_CAP];
+    uint64_t think_ms[STATS_CAP];
+    uint32_t pos_guesses[MAX_WORD_LEN][STATS_CAP];
+    uint32_t pos_correct[MAX_WORD_LEN][STATS_CAP];
+    // Not on disk: column index + 1 by name hash (linear probing), 0 = empty
+    uint32_t index[STATS_HASH_CAP];
+} stats_columns_t;
+
+// One broadcast event in both encodings, written once by its publisher and
+// read in place by every recipient's drain until refs drops to 0
+typedef struct {
+    int refs;                               // publisher + queue handles; atomic
+    uint16_t tlen;                          // text line incl. '\n', 0 if not built
+    uint16_t flen;                          // wire.h frame, 0 if not built
+    char text[OUT_MSG_LEN + 1];
+    uint8_t frame[WIRE_MAX_FRAME];
+} out_msg_t;
+
 typedef struct {
     // --- Global protection for game state ---
     pthread_mutex_t game_mtx;      // process-shared
-    pthread_mutex_t score_mtx;     // process-shared
+    pthread_mutex_t score_save_mtx; // process-shared, serializes scores.txt writers only
+    pthread_mutex_t stats_mtx;     // process-shared, guards stats
 
     // --- Turn control ---
     sem_t turn_sem[MAX_PLAYERS];   // process-shared semaphores (child waits, scheduler posts)
@@ -76,19 +177,36 @@ typedef struct {
     game_phase_t phase;
 
     int connected[MAX_PLAYERS];    // 1 if connected, 0 if disconnected
+
+    // Resumable sessions: a dropped player's slot stays reserved under its
+    // token until grace_until_ms, and RESUME <token> takes it back
+    uint64_t session_token[MAX_PLAYERS];   // 0 = slot free
+    pid_t session_pid[MAX_PLAYERS];        // child serving the slot, 0 while dropped
+    uint64_t grace_until_ms[MAX_PLAYERS];  // mono_ms() deadline while dropped, else 0
+    int grace_ms;                          // --grace; 0 frees a dropped slot at once
+    int binary[MAX_PLAYERS];               // 1: the slot's client speaks wire.h frames
     int current_turn;              // player id whose turn (1 or 2 for guessers); 0 for wordmaster when prompting word
-    int position_idx;              // 0..4
     int guess_count_for_pos;       // 0,1,2 for each position (how many guessers have guessed)
-    int score[MAX_PLAYERS];        // score[1], score[2] used
-    int pass_num;        // 0..4 (each pass = one full sweep over positions 0..4)
 
-    char secret_word[WORD_LEN + 1];
-    char display[WORD_LEN + 1];    // '_' placeholders to show progress
+    // Secret, display, position/pass and scores; rules live in engine.c
+    int word_len;                  // fixed for the room's lifetime
+    int auto_word;                 // 1: server picks secrets, slot 0 stays empty
+    int word_rules;                // 1: --rules=word, guessers send GUESSWORD
+    engine_game_t game;
 
     char player_name[MAX_PLAYERS][NAME_LEN];  // from client NAME message
 
-    // Persistent score table in memory (simple: index by player id 1/2, plus optional names)
-    score_entry_t score_table[MAX_PLAYERS];   // score_table[1] and [2] = guessers' lifetime wins
+    // Persistent score store keyed by player name, split into lock stripes
+    score_stripe_t score_stripes[SCORE_STRIPES];
+    uint32_t score_epoch;          // bumped (all stripes held) to start a snapshot
+    uint32_t score_idx_gen;        // bumped each time scores_rebuild() replaces scores.idx
+    int scores_ready;              // set once scores.txt has been applied
+
+    // Per-room stats buffer (game_mtx) and merged lifetime stats (stats_mtx)
+    room_stats_t room_stats[MAX_PLAYERS];
+    arc_game_t cur_game;           // archive record being built (game_mtx)
+    stats_columns_t stats;
+    int stats_dirty_games;         // games merged since last flush
 
     // Multi-game counter
     int game_number;
@@ -101,19 +219,52 @@ typedef struct {
     int log_tail;
     char logq[LOGQ_CAP][LOG_MSG_LEN];
 
-    // --- Per-player outgoing broadcast queues ---
+    // --- Per-player outgoing broadcast queues (handles into out_pool) ---
     pthread_mutex_t out_mtx[MAX_PLAYERS];   // process-shared
     sem_t out_items[MAX_PLAYERS];           // number of queued messages
     sem_t out_spaces[MAX_PLAYERS];          // free slots
     int out_head[MAX_PLAYERS];
     int out_tail[MAX_PLAYERS];
-    char outq[MAX_PLAYERS][OUTQ_CAP][OUT_MSG_LEN];
+    uint16_t outq[MAX_PLAYERS][OUTQ_CAP];
+
+    // --- Shared message buffers: serialized once, freed by the last reader ---
+    pthread_mutex_t out_pool_mtx;           // guards the free stack only
+    int out_nfree;
+    uint16_t out_free[OUT_POOL_CAP];
+    out_msg_t out_pool[OUT_POOL_CAP];
 } shared_t;
 
 // Global pointers in parent process
 static int g_listen_fd = -1;
+// Mapped by the parent before fork, so children share the same read-only pages
+static score_index_t g_score_idx;
+static uint32_t g_score_idx_gen;   // g_sh->score_idx_gen that g_score_idx maps
+static dict_t g_dict;
+static rank_t g_rank;
 static shared_t *g_sh = NULL;
 
+// --auto word pool, parent only (the scheduler draws from it)
+typedef struct {
+    uint64_t *words;               // dict_pack() keys, easiest first
+    size_t n;
+    size_t bucket_start[AUTO_BUCKETS + 1];
+    int bucket;                    // fixed bucket, or -1 for any
+    uint64_t rng;                  // xorshift state
+    float bucket_guesses[AUTO_BUCKETS];  // hardest word's mean guesses per bucket (rank.idx only)
+} auto_pool_t;
+
+static auto_pool_t g_auto = { .bucket = -1 };
+
+// --record: opened by the parent before fork, appended to by every process
+static int g_rec_fd = -1;
+static uint64_t g_rec_start_ms;
+
+// Set in a child whose slot was taken over by a RESUME elsewhere
+static volatile sig_atomic_t g_superseded = 0;
+// Set in a child whose client negotiated wire.h frames
+static int g_binary = 0;
+static const char *const g_auto_bucket_names[AUTO_BUCKETS] = { "easy", "medium", "hard" };
+
 // ---------- Utility: time string ----------
 static void now_str(char *buf, size_t n) {
     struct timespec ts;
@@ -125,6 +276,12 @@ static void now_str(char *buf, size_t n) {
              tm.tm_hour, tm.tm_min, tm.tm_sec);
 }
 
+static uint64_t mono_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)(ts.tv_nsec / 1000000);
+}
+
 // ---------- Logger queue API (safe across processes) ----------
 static void log_enqueuef(const char *fmt, ...) {
     if (!g_sh) return;
@@ -157,7 +314,7 @@ static ssize_t send_all(int fd, const void *buf, size_t len) {
     const char *p = (const char*)buf;
     size_t off = 0;
     while (off < len) {
-        ssize_t w = send(fd, p + off, len - off, 0);
+        ssize_t w = send(fd, p + off, len - off, MSG_NOSIGNAL);   // a dropped peer is an error, not SIGPIPE
         if (w < 0) {
             if (errno == EINTR) continue;
             return -1;
@@ -168,7 +325,15 @@ static ssize_t send_all(int fd, const void *buf, size_t len) {
     return (ssize_t)off;
 }
 
+static int send_frame(int fd, const uint8_t *frame, size_t n) {
+    return (send_all(fd, frame, n) < 0) ? -1 : 0;
+}
+
 static int send_line(int fd, const char *line) {
+    if (g_binary) {
+        uint8_t f[WIRE_MAX_FRAME];
+        return send_frame(fd, f, wire_put_text(f, line));
+    }
     // sends line plus '\n'
     char buf[512];
     snprintf(buf, sizeof(buf), "%s\n", line);
@@ -180,9 +345,10 @@ static ssize_t recv_line(int fd, char *out, size_t cap) {
     size_t n = 0;
     while (n + 1 < cap) {
         char c;
+        if (g_superseded) return -1;
         ssize_t r = recv(fd, &c, 1, 0);
         if (r < 0) {
-            if (errno == EINTR) continue;
+            if (errno == EINTR) continue;   // g_superseded is checked on the next pass
             return -1;
         }
         if (r == 0) return 0; // closed
@@ -194,61 +360,505 @@ static ssize_t recv_line(int fd, char *out, size_t cap) {
     return (ssize_t)n;
 }
 
-// ---------- scores.txt persistence ----------
-static void scores_load(const char *path) {
-    pthread_mutex_lock(&g_sh->score_mtx);
+// While waiting for a turn nothing is read, so a client that went away is
+// only noticed when a send fails; a room between games sends nothing and
+// would keep the dead seat. 1 once the peer has closed (no unread data).
+static int peer_closed(int fd) {
+    char c;
+    ssize_t r = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+// ---------- Striped score store ----------
+static int score_stripe_of(const char *name) {
+    return (int)(score_name_hash(name) & (SCORE_STRIPES - 1));
+}
+
+// Remaps scores.idx if another process rebuilt it: the old mapping stays
+// valid but lacks the players evicted into the new one
+static void score_index_refresh(void) {
+    uint32_t gen = __atomic_load_n(&g_sh->score_idx_gen, __ATOMIC_ACQUIRE);
+    if (gen == g_score_idx_gen) return;
+    score_index_t ix;
+    if (score_index_open(&ix, SCORES_IDX) != 0) return;
+    score_index_close(&g_score_idx);
+    g_score_idx = ix;
+    g_score_idx_gen = gen;
+}
+
+static score_entry_t *score_find_locked(score_stripe_t *st, const char *name, int create) {
+    // st->mtx must be held. Probes start from the high hash bits, the low
+    // bits already picked the stripe.
+    uint32_t i = (score_name_hash(name) >> 16) & (SCORE_STRIPE_CAP - 1);
+    for (int n = 0; n < SCORE_STRIPE_CAP; n++) {
+        score_entry_t *e = &st->slots[i];
+        if (!e->used) {
+            if (!create || st->count >= SCORE_STRIPE_CAP - 1) return NULL;
+            e->used = 1;
+            snprintf(e->name, NAME_LEN, "%s", name);
+            e->val.present = 1;
+            e->val.wins = 0;
+            e->val.rating = RATING_INITIAL;
+            e->val.slot = 0;
+            // Not in memory yet: seed from the on-disk index if it has the player
+            score_index_refresh();
+            const score_idx_rec_t *r = score_index_find(&g_score_idx, name);
+            if (r) {
+                e->val.wins = r->wins;
+                e->val.rating = r->rating;
+                e->val.slot = r->slot;
+            }
+            // Did not exist when the current snapshot epoch began
+            e->snap_epoch = g_sh->score_epoch;
+            e->snap.present = 0;
+            st->count++;
+            return e;
+        }
+        if (strncmp(e->name, name, NAME_LEN) == 0) return e;
+        i = (i + 1) & (SCORE_STRIPE_CAP - 1);
+    }
+    return NULL;
+}
+
+static void score_touch_locked(score_entry_t *e) {
+    // Stripe lock held; call before modifying e->val. Saves the value as of
+    // the start of the current snapshot epoch (once per epoch per entry).
+    if (e->snap_epoch != g_sh->score_epoch) {
+        e->snap = e->val;
+        e->snap_epoch = g_sh->score_epoch;
+    }
+}
 
-    // initialize defaults
-    for (int i = 0; i < MAX_PLAYERS; i++) {
-        g_sh->score_table[i].name[0] = '\0';
-        g_sh->score_table[i].wins = 0;
+static int scores_rebuild(void);
+
+static void scores_record_game(const char *name1, const char *name2, int winner,
+                               double *r1_out, double *r2_out) {
+    // scores.txt may still be loading; its values are newer than the index
+    while (!__atomic_load_n(&g_sh->scores_ready, __ATOMIC_ACQUIRE)) usleep(1000);
+
+    // Locks at most two stripes, always in index order
+    int a = score_stripe_of(name1);
+    int b = score_stripe_of(name2);
+    int lo = (a < b) ? a : b;
+    int hi = (a < b) ? b : a;
+    score_entry_t *e1, *e2;
+    for (int rebuilt = 0; ; rebuilt = 1) {
+        pthread_mutex_lock(&g_sh->score_stripes[lo].mtx);
+        if (hi != lo) pthread_mutex_lock(&g_sh->score_stripes[hi].mtx);
+        e1 = score_find_locked(&g_sh->score_stripes[a], name1, 1);
+        e2 = score_find_locked(&g_sh->score_stripes[b], name2, 1);
+        if ((e1 && e2) || rebuilt) break;
+
+        // A full stripe: make room by moving clean players into scores.idx
+        if (hi != lo) pthread_mutex_unlock(&g_sh->score_stripes[hi].mtx);
+        pthread_mutex_unlock(&g_sh->score_stripes[lo].mtx);
+        if (scores_rebuild() != 0) {
+            pthread_mutex_lock(&g_sh->score_stripes[lo].mtx);
+            if (hi != lo) pthread_mutex_lock(&g_sh->score_stripes[hi].mtx);
+            e1 = score_find_locked(&g_sh->score_stripes[a], name1, 0);
+            e2 = score_find_locked(&g_sh->score_stripes[b], name2, 0);
+            break;
+        }
+    }
+    double r1 = RATING_INITIAL, r2 = RATING_INITIAL;
+    if (e1) { score_touch_locked(e1); r1 = e1->val.rating; e1->val.slot = 1; }
+    if (e2) { score_touch_locked(e2); r2 = e2->val.rating; e2->val.slot = 2; }
+
+    elo_update(&r1, &r2, winner == 1 ? 1.0 : (winner == 2 ? 0.0 : 0.5));
+    if (e1) {
+        e1->val.rating = r1;
+        if (winner == 1) e1->val.wins += 1;
     }
-    strncpy(g_sh->score_table[1].name, "GuesserA", NAME_LEN - 1);
-    strncpy(g_sh->score_table[2].name, "GuesserB", NAME_LEN - 1);
+    if (e2 && e2 != e1) {
+        e2->val.rating = r2;
+        if (winner == 2) e2->val.wins += 1;
+    }
+
+    if (hi != lo) pthread_mutex_unlock(&g_sh->score_stripes[hi].mtx);
+    pthread_mutex_unlock(&g_sh->score_stripes[lo].mtx);
 
+    if (!e1) log_enqueuef("Score store full: dropped %s's result (wins/rating not updated).", name1);
+    if (!e2) log_enqueuef("Score store full: dropped %s's result (wins/rating not updated).", name2);
+    *r1_out = r1;
+    *r2_out = r2;
+}
+
+// ---------- scores.txt / scores.idx persistence ----------
+static void scores_load(const char *path) {
     FILE *f = fopen(path, "r");
     if (!f) {
         // create if missing
         f = fopen(path, "w");
         if (f) fclose(f);
-        pthread_mutex_unlock(&g_sh->score_mtx);
         return;
     }
 
     // File format (simple):
-    // player_id wins name
-    // e.g.: 1 3 Alice
-    //       2 1 Bob
-    int pid, wins;
-    char name[NAME_LEN];
-    while (fscanf(f, "%d %d %31s", &pid, &wins, name) == 3) {
-        if (pid >= 0 && pid < MAX_PLAYERS) {
-            g_sh->score_table[pid].wins = wins;
-            strncpy(g_sh->score_table[pid].name, name, NAME_LEN - 1);
-            g_sh->score_table[pid].name[NAME_LEN - 1] = '\0';
+    // player_id wins name rating
+    // e.g.: 1 3 Alice 1531.2
+    //       2 1 Bob 1468.8
+    // player_id is the slot the player last played in. Older files without
+    // the rating column load with RATING_INITIAL. Only players touched since
+    // scores.idx was rebuilt are listed, so this stays small.
+    char buf[256];
+    while (fgets(buf, sizeof(buf), f)) {
+        int pid, wins;
+        char name[NAME_LEN];
+        double rating = RATING_INITIAL;
+        if (sscanf(buf, "%d %d %31s %lf", &pid, &wins, name, &rating) < 3) continue;
+
+        score_stripe_t *st = &g_sh->score_stripes[score_stripe_of(name)];
+        for (int rebuilt = 0; ; rebuilt = 1) {
+            pthread_mutex_lock(&st->mtx);
+            score_entry_t *e = score_find_locked(st, name, 1);
+            if (e) {
+                e->val.wins = wins;
+                e->val.rating = rating;
+                e->val.slot = pid;
+            }
+            pthread_mutex_unlock(&st->mtx);
+            if (e) break;
+            if (rebuilt || scores_rebuild() != 0) {
+                log_enqueuef("Score store full: dropped %s from %s.", name, path);
+                break;
+            }
         }
     }
     fclose(f);
+}
+
+// ---------- games.arc archive ----------
+static void archive_append(const arc_game_t *g) {
+    // O_APPEND keeps concurrent appenders from interleaving inside a record
+    int fd = open(ARCHIVE_PATH, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return;
+    if (write(fd, g, sizeof(*g)) != (ssize_t)sizeof(*g)) {
+        log_enqueuef("Short write to %s.", ARCHIVE_PATH);
+    }
+    close(fd);
+}
+
+// ---------- --record input log (see rec.h) ----------
+// Called with game_mtx held, so file order is the order inputs were applied
+static void record_append(rec_event_t *e) {
+    if (g_rec_fd < 0) return;
+    e->t_ms = (uint32_t)(mono_ms() - g_rec_start_ms);
+    if (write(g_rec_fd, e, sizeof(*e)) != (ssize_t)sizeof(*e)) {
+        log_enqueuef("Recording write failed: %s", strerror(errno));
+    }
+}
+
+static void *score_loader_thread_main(void *arg) {
+    (void)arg;
+    uint64_t t0 = mono_ms();
+    scores_load(SCORES_TXT);
+    __atomic_store_n(&g_sh->scores_ready, 1, __ATOMIC_RELEASE);
+    log_enqueuef("Score store ready in %llu ms (%llu players in %s).",
+                 (unsigned long long)(mono_ms() - t0),
+                 (unsigned long long)g_score_idx.count, SCORES_IDX);
+    return NULL;
+}
 
-    pthread_mutex_unlock(&g_sh->score_mtx);
+_Static_assert(NAME_LEN <= SCORE_IDX_NAME_LEN, "score names must fit a scores.idx record");
+
+static size_t scores_snapshot(score_idx_rec_t **out) {
+    // Point-in-time snapshot without holding writers off for the file I/O:
+    // bump the epoch with every stripe held (no I/O, just the flip), then
+    // walk the stripes one at a time. Entries written since the flip carry
+    // their pre-flip value in snap, so the result reflects the flip instant.
+    // score_save_mtx must be held.
+    for (int i = 0; i < SCORE_STRIPES; i++) pthread_mutex_lock(&g_sh->score_stripes[i].mtx);
+    uint32_t epoch = ++g_sh->score_epoch;
+    for (int i = SCORE_STRIPES - 1; i >= 0; i--) pthread_mutex_unlock(&g_sh->score_stripes[i].mtx);
+
+    size_t n = 0, cap = 256;
+    score_idx_rec_t *recs = malloc(cap * sizeof(*recs));
+
+    static score_entry_t copy[SCORE_STRIPE_CAP];
+    for (int i = 0; recs && i < SCORE_STRIPES; i++) {
+        score_stripe_t *st = &g_sh->score_stripes[i];
+        pthread_mutex_lock(&st->mtx);
+        memcpy(copy, st->slots, sizeof(copy));
+        pthread_mutex_unlock(&st->mtx);
+
+        for (int k = 0; k < SCORE_STRIPE_CAP; k++) {
+            const score_entry_t *e = &copy[k];
+            if (!e->used) continue;
+            const score_value_t *v = (e->snap_epoch == epoch) ? &e->snap : &e->val;
+            if (!v->present) continue;
+
+            if (n == cap) {
+                cap *= 2;
+                score_idx_rec_t *grown = realloc(recs, cap * sizeof(*recs));
+                if (!grown) { free(recs); recs = NULL; n = 0; break; }
+                recs = grown;
+            }
+            score_idx_rec_t *r = &recs[n++];
+            memset(r, 0, sizeof(*r));
+            memcpy(r->name, e->name, NAME_LEN);   // NUL-terminated within NAME_LEN
+            r->hash = score_name_hash(r->name);
+            r->wins = v->wins;
+            r->slot = v->slot;
+            r->rating = v->rating;
+        }
+    }
+
+    *out = recs;
+    return n;
+}
+
+static void scores_save_locked(const char *path) {
+    // score_save_mtx must be held
+    score_idx_rec_t *recs = NULL;
+    size_t n = scores_snapshot(&recs);
+
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = recs ? fopen(tmp, "w") : NULL;
+    if (f) {
+        for (size_t i = 0; i < n; i++) {
+            fprintf(f, "%d %d %s %.1f\n", recs[i].slot, recs[i].wins, recs[i].name, recs[i].rating);
+        }
+        int err = ferror(f);
+        if (fclose(f) != 0) err = 1;
+        if (!err) rename(tmp, path);
+    }
+    free(recs);
 }
 
 static void scores_save(const char *path) {
-    pthread_mutex_lock(&g_sh->score_mtx);
+    pthread_mutex_lock(&g_sh->score_save_mtx);
+    scores_save_locked(path);
+    pthread_mutex_unlock(&g_sh->score_save_mtx);
+}
+
+// Puts a copy of e into the first free slot of its probe chain
+static void score_insert_locked(score_stripe_t *st, const score_entry_t *e) {
+    uint32_t i = (score_name_hash(e->name) >> 16) & (SCORE_STRIPE_CAP - 1);
+    while (st->slots[i].used) i = (i + 1) & (SCORE_STRIPE_CAP - 1);
+    st->slots[i] = *e;
+    st->count++;
+}
+
+// A stripe is full: fold every player into a fresh scores.idx, then drop
+// the entries it now serves (those not written since the snapshot) so
+// their slots can be reused; they are seeded from the index again on their
+// next game. scores.txt is rewritten to list only the players kept.
+// No stripe lock may be held. Returns 0, or -1 if the index was not written.
+static int scores_rebuild(void) {
+    pthread_mutex_lock(&g_sh->score_save_mtx);
+    score_index_refresh();
+
+    uint64_t t0 = mono_ms();
+    score_idx_rec_t *recs = NULL;
+    size_t n = scores_snapshot(&recs);
+    uint32_t epoch = g_sh->score_epoch;        // the snapshot's flip; only bumped under score_save_mtx
+    if (!recs || score_index_write_merged(SCORES_IDX, &g_score_idx, recs, n) != 0) {
+        free(recs);
+        pthread_mutex_unlock(&g_sh->score_save_mtx);
+        log_enqueuef("Score store full and %s could not be rebuilt.", SCORES_IDX);
+        return -1;
+    }
+    free(recs);
+    // Before any eviction, so a lookup that misses in memory maps the new index
+    __atomic_add_fetch(&g_sh->score_idx_gen, 1, __ATOMIC_RELEASE);
+    score_index_refresh();
+
+    size_t evicted = 0;
+    static score_entry_t keep[SCORE_STRIPE_CAP];
+    for (int i = 0; i < SCORE_STRIPES; i++) {
+        score_stripe_t *st = &g_sh->score_stripes[i];
+        pthread_mutex_lock(&st->mtx);
+        int nk = 0;
+        for (int k = 0; k < SCORE_STRIPE_CAP; k++) {
+            if (!st->slots[k].used) continue;
+            if (st->slots[k].snap_epoch == epoch) keep[nk++] = st->slots[k];    // written since the flip
+            else evicted++;
+        }
+        memset(st->slots, 0, sizeof(st->slots));
+        st->count = 0;
+        for (int k = 0; k < nk; k++) score_insert_locked(st, &keep[k]);
+        pthread_mutex_unlock(&st->mtx);
+    }
+    scores_save_locked(SCORES_TXT);
+    pthread_mutex_unlock(&g_sh->score_save_mtx);
+
+    log_enqueuef("Score store full: rebuilt %s in %llu ms, %zu players moved out of memory.",
+                 SCORES_IDX, (unsigned long long)(mono_ms() - t0), evicted);
+    return 0;
+}
 
-    FILE *f = fopen(path, "w");
+static void scores_compact(void) {
+    // Fold the in-memory players into a fresh scores.idx (shutdown only).
+    // The index then holds all of them, so scores.txt starts over empty and
+    // lists only players touched after this rebuild.
+    pthread_mutex_lock(&g_sh->score_save_mtx);
+    score_index_refresh();      // players evicted by scores_rebuild() live only there
+
+    score_idx_rec_t *recs = NULL;
+    size_t n = scores_snapshot(&recs);
+    if (recs && score_index_write_merged(SCORES_IDX, &g_score_idx, recs, n) != 0) {
+        perror("scores_compact");
+    } else if (recs) {
+        FILE *f = fopen(SCORES_TXT ".tmp", "w");
+        if (!f || fclose(f) != 0 || rename(SCORES_TXT ".tmp", SCORES_TXT) != 0) perror("scores_compact: " SCORES_TXT);
+    }
+    free(recs);
+
+    pthread_mutex_unlock(&g_sh->score_save_mtx);
+}
+
+// ---------- stats.col persistence ----------
+// File format (binary, host endian):
+//   header: magic, positions, count, reserved (uint32 each)
+//   then every column of stats_columns_t, each holding `count` values
+static int stats_find_or_add_locked(const char *name) {
+    // stats_mtx must be held; -1 once STATS_CAP players are stored
+    stats_columns_t *st = &g_sh->stats;
+    uint32_t h = score_name_hash(name) & (STATS_HASH_CAP - 1);
+    for (; st->index[h]; h = (h + 1) & (STATS_HASH_CAP - 1)) {
+        int i = (int)st->index[h] - 1;
+        if (strncmp(st->name[i], name, NAME_LEN) == 0) return i;
+    }
+    if (st->count >= STATS_CAP) return -1;
+    int i = st->count++;
+    snprintf(st->name[i], NAME_LEN, "%s", name);
+    st->index[h] = (uint32_t)i + 1;
+    return i;
+}
+
+static void stats_reindex_locked(void) {
+    // stats_mtx must be held; after the columns were loaded into the fresh
+    // segment, whose index is still all zero
+    stats_columns_t *st = &g_sh->stats;
+    for (int i = 0; i < st->count; i++) {
+        uint32_t h = score_name_hash(st->name[i]) & (STATS_HASH_CAP - 1);
+        while (st->index[h]) h = (h + 1) & (STATS_HASH_CAP - 1);
+        st->index[h] = (uint32_t)i + 1;
+    }
+}
+
+static void stats_load(const char *path) {
+    pthread_mutex_lock(&g_sh->stats_mtx);
+    stats_columns_t *st = &g_sh->stats;
+    st->count = 0;
+
+    FILE *f = fopen(path, "rb");
     if (!f) {
-        pthread_mutex_unlock(&g_sh->score_mtx);
+        pthread_mutex_unlock(&g_sh->stats_mtx);
         return;
     }
 
-    for (int pid = 1; pid <= 2; pid++) {
-        fprintf(f, "%d %d %s\n", pid, g_sh->score_table[pid].wins,
-                g_sh->score_table[pid].name[0] ? g_sh->score_table[pid].name : (pid == 1 ? "GuesserA" : "GuesserB"));
+    uint32_t hdr[4];
+    if (fread(hdr, sizeof(hdr), 1, f) != 1 || hdr[0] != STATS_MAGIC ||
+        hdr[1] > MAX_WORD_LEN || hdr[2] > STATS_CAP) {
+        fclose(f);
+        pthread_mutex_unlock(&g_sh->stats_mtx);
+        return;
+    }
+
+    size_t n = hdr[2];
+    int ok = fread(st->name, NAME_LEN, n, f) == n &&
+             fread(st->games, sizeof(uint32_t), n, f) == n &&
+             fread(st->guesses, sizeof(uint32_t), n, f) == n &&
+             fread(st->correct, sizeof(uint32_t), n, f) == n &&
+             fread(st->present, sizeof(uint32_t), n, f) == n &&
+             fread(st->absent, sizeof(uint32_t), n, f) == n &&
+             fread(st->think_ms, sizeof(uint64_t), n, f) == n;
+    // Files written before variable-length rooms carry 5 positions
+    for (int p = 0; ok && p < (int)hdr[1]; p++) {
+        ok = fread(st->pos_guesses[p], sizeof(uint32_t), n, f) == n &&
+             fread(st->pos_correct[p], sizeof(uint32_t), n, f) == n;
+    }
+    fclose(f);
+
+    // A truncated file is ignored rather than half-loaded; only the rows
+    // fread() may have written are cleared
+    if (ok) {
+        st->count = (int)n;
+    } else {
+        memset(st->name, 0, n * NAME_LEN);
+        memset(st->games, 0, n * sizeof(uint32_t));
+        memset(st->guesses, 0, n * sizeof(uint32_t));
+        memset(st->correct, 0, n * sizeof(uint32_t));
+        memset(st->present, 0, n * sizeof(uint32_t));
+        memset(st->absent, 0, n * sizeof(uint32_t));
+        memset(st->think_ms, 0, n * sizeof(uint64_t));
+        for (int p = 0; p < MAX_WORD_LEN; p++) {
+            memset(st->pos_guesses[p], 0, n * sizeof(uint32_t));
+            memset(st->pos_correct[p], 0, n * sizeof(uint32_t));
+        }
+    }
+    stats_reindex_locked();
+    pthread_mutex_unlock(&g_sh->stats_mtx);
+}
+
+static void stats_save(const char *path) {
+    char tmp[256];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    pthread_mutex_lock(&g_sh->stats_mtx);
+    stats_columns_t *st = &g_sh->stats;
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        pthread_mutex_unlock(&g_sh->stats_mtx);
+        return;
     }
+
+    size_t n = (size_t)st->count;
+    uint32_t hdr[4] = { STATS_MAGIC, MAX_WORD_LEN, (uint32_t)n, 0 };
+    fwrite(hdr, sizeof(hdr), 1, f);
+    fwrite(st->name, NAME_LEN, n, f);
+    fwrite(st->games, sizeof(uint32_t), n, f);
+    fwrite(st->guesses, sizeof(uint32_t), n, f);
+    fwrite(st->correct, sizeof(uint32_t), n, f);
+    fwrite(st->present, sizeof(uint32_t), n, f);
+    fwrite(st->absent, sizeof(uint32_t), n, f);
+    fwrite(st->think_ms, sizeof(uint64_t), n, f);
+    for (int p = 0; p < MAX_WORD_LEN; p++) {
+        fwrite(st->pos_guesses[p], sizeof(uint32_t), n, f);
+        fwrite(st->pos_correct[p], sizeof(uint32_t), n, f);
+    }
+    int err = ferror(f);
     fclose(f);
+    g_sh->stats_dirty_games = 0;
+
+    pthread_mutex_unlock(&g_sh->stats_mtx);
 
-    pthread_mutex_unlock(&g_sh->score_mtx);
+    // Replace atomically so readers never see a partial file
+    if (!err) rename(tmp, path);
+}
+
+static void stats_merge_room_locked(void) {
+    // game_mtx must be held; folds both guessers' room buffers into stats
+    pthread_mutex_lock(&g_sh->stats_mtx);
+    stats_columns_t *st = &g_sh->stats;
+
+    for (int pid = 1; pid <= 2; pid++) {
+        room_stats_t *rs = &g_sh->room_stats[pid];
+        const char *name = g_sh->player_name[pid][0] ? g_sh->player_name[pid]
+                                                     : (pid == 1 ? "GuesserA" : "GuesserB");
+        int i = stats_find_or_add_locked(name);
+        if (i >= 0) {
+            st->games[i] += 1;
+            st->guesses[i] += rs->guesses;
+            st->correct[i] += rs->correct;
+            st->present[i] += rs->present;
+            st->absent[i] += rs->absent;
+            st->think_ms[i] += rs->think_ms;
+            for (int p = 0; p < MAX_WORD_LEN; p++) {
+                st->pos_guesses[p][i] += rs->pos_guesses[p];
+                st->pos_correct[p][i] += rs->pos_correct[p];
+            }
+        } else {
+            log_enqueuef("%s full (%d players): dropped this game's stats for %s.", STATS_PATH, STATS_CAP, name);
+        }
+        memset(rs, 0, sizeof(*rs));
+    }
+    g_sh->stats_dirty_games++;
+
+    pthread_mutex_unlock(&g_sh->stats_mtx);
 }
 
 // ---------- Shared memory init ----------
@@ -290,16 +900,20 @@ static void shm_init_or_attach(bool create) {
     g_sh = (shared_t*)mem;
 
     if (create) {
-        memset(g_sh, 0, sizeof(*g_sh));
+        // A new (O_EXCL) object is zero-filled by ftruncate(); no memset, so
+        // the stats columns cost memory only for the rows actually used
 
         init_process_shared_mutex(&g_sh->game_mtx);
-        init_process_shared_mutex(&g_sh->score_mtx);
+        init_process_shared_mutex(&g_sh->score_save_mtx);
+        for (int i = 0; i < SCORE_STRIPES; i++) {
+            init_process_shared_mutex(&g_sh->score_stripes[i].mtx);
+        }
+        init_process_shared_mutex(&g_sh->stats_mtx);
         init_process_shared_mutex(&g_sh->log_mtx);
 
         for (int i = 0; i < MAX_PLAYERS; i++) {
             sem_init(&g_sh->turn_sem[i], 1, 0); // pshared=1
             g_sh->connected[i] = 0;
-            g_sh->score[i] = 0;
             g_sh->player_name[i][0] = '\0';
         }
 
@@ -315,14 +929,15 @@ static void shm_init_or_attach(bool create) {
             g_sh->out_head[i] = 0;
             g_sh->out_tail[i] = 0;
         }
+        init_process_shared_mutex(&g_sh->out_pool_mtx);
+        g_sh->out_nfree = OUT_POOL_CAP;
+        for (int i = 0; i < OUT_POOL_CAP; i++) g_sh->out_free[i] = (uint16_t)(OUT_POOL_CAP - 1 - i);
 
         g_sh->phase = PHASE_WAITING_PLAYERS;
         g_sh->current_turn = 0;
-        g_sh->position_idx = 0;
         g_sh->guess_count_for_pos = 0;
-        g_sh->secret_word[0] = '\0';
-        for (int i = 0; i < WORD_LEN; i++) g_sh->display[i] = '_';
-        g_sh->display[WORD_LEN] = '\0';
+        g_sh->word_len = WORD_LEN;
+        engine_new_game(&g_sh->game, NULL, g_sh->word_len);
 
         g_sh->game_number = 0;
         g_sh->shutting_down = 0;
@@ -343,38 +958,103 @@ static void sigint_handler(int signo) {
     if (g_sh) g_sh->shutting_down = 1;
 }
 
-static void out_enqueue(int target_player, const char *msg) {
-    if (target_player < 0 || target_player >= MAX_PLAYERS) return;
+// ---------- Shared message buffers ----------
+// A publisher takes a buffer (refs = 1), serializes the event into it once,
+// hands it to each recipient queue (one ref per handle) and drops its own
+// ref; the drain that sends the last copy returns the buffer to the pool.
+
+// Returns a buffer with one ref for the caller, or -1 if the pool is empty
+// (cannot happen while OUT_POOL_CAP covers every queue slot)
+static int out_msg_new(void) {
+    pthread_mutex_lock(&g_sh->out_pool_mtx);
+    int h = g_sh->out_nfree > 0 ? g_sh->out_free[--g_sh->out_nfree] : -1;
+    pthread_mutex_unlock(&g_sh->out_pool_mtx);
+    if (h < 0) return -1;
+    out_msg_t *m = &g_sh->out_pool[h];
+    m->tlen = m->flen = 0;
+    m->text[0] = '\0';
+    __atomic_store_n(&m->refs, 1, __ATOMIC_RELAXED);
+    return h;
+}
+
+// Finishes the text line that was written into m->text (if any)
+static void out_msg_seal(int h) {
+    if (h < 0) return;
+    out_msg_t *m = &g_sh->out_pool[h];
+    size_t n = strnlen(m->text, OUT_MSG_LEN);
+    if (m->text[0] && n < OUT_MSG_LEN) {
+        m->text[n++] = '\n';
+        m->tlen = (uint16_t)n;
+    }
+}
+
+static void out_msg_release(int h) {
+    if (h < 0) return;
+    if (__atomic_sub_fetch(&g_sh->out_pool[h].refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+    pthread_mutex_lock(&g_sh->out_pool_mtx);
+    g_sh->out_free[g_sh->out_nfree++] = (uint16_t)h;
+    pthread_mutex_unlock(&g_sh->out_pool_mtx);
+}
+
+// Sends h in this connection's protocol straight from the shared buffer
+static int out_msg_send(int fd, int h) {
+    if (h < 0) return 0;
+    const out_msg_t *m = &g_sh->out_pool[h];
+    if (g_binary && m->flen) return send_frame(fd, m->frame, m->flen);
+    if (!m->tlen) return 0;                // protocol switched by a RESUME just now
+    if (!g_binary) return (send_all(fd, m->text, m->tlen) < 0) ? -1 : 0;
+    char line[OUT_MSG_LEN];                // text only: as a WIRE_TEXT frame
+    snprintf(line, sizeof(line), "%.*s", (int)m->tlen - 1, m->text);
+    return send_line(fd, line);
+}
+
+// Queues a handle to h for a player (taking a ref); the drain sends it in
+// that player's protocol
+static void out_enqueue(int target_player, int h) {
+    if (h < 0 || target_player < 0 || target_player >= MAX_PLAYERS) return;
+    if (target_player == 0 && g_sh->auto_word) return;   // nobody drains slot 0
 
     // If queue is full, drop the message to avoid blocking gameplay
     if (sem_trywait(&g_sh->out_spaces[target_player]) != 0) return;
 
+    __atomic_add_fetch(&g_sh->out_pool[h].refs, 1, __ATOMIC_RELAXED);
     pthread_mutex_lock(&g_sh->out_mtx[target_player]);
     int idx = g_sh->out_tail[target_player];
     g_sh->out_tail[target_player] = (g_sh->out_tail[target_player] + 1) % OUTQ_CAP;
-
-    snprintf(g_sh->outq[target_player][idx], OUT_MSG_LEN, "%s", msg);
-
+    g_sh->outq[target_player][idx] = (uint16_t)h;
     pthread_mutex_unlock(&g_sh->out_mtx[target_player]);
     sem_post(&g_sh->out_items[target_player]);
 }
 
-static void out_drain_to_socket(int my_id, int client_fd) {
-    // Drain everything currently queued for this player
-    while (sem_trywait(&g_sh->out_items[my_id]) == 0) {
-        pthread_mutex_lock(&g_sh->out_mtx[my_id]);
-
-        int idx = g_sh->out_head[my_id];
-        g_sh->out_head[my_id] = (g_sh->out_head[my_id] + 1) % OUTQ_CAP;
-
-        char msg[OUT_MSG_LEN];
-        snprintf(msg, sizeof(msg), "%s", g_sh->outq[my_id][idx]);
+// Takes the oldest handle off a player's queue, or -1 if it is empty. The
+// slot is freed only after the caller releases the handle, so queued and
+// in-flight handles together never outnumber the queue slots.
+static int out_dequeue(int id) {
+    if (sem_trywait(&g_sh->out_items[id]) != 0) return -1;
+    pthread_mutex_lock(&g_sh->out_mtx[id]);
+    int h = g_sh->outq[id][g_sh->out_head[id]];
+    g_sh->out_head[id] = (g_sh->out_head[id] + 1) % OUTQ_CAP;
+    pthread_mutex_unlock(&g_sh->out_mtx[id]);
+    return h;
+}
 
-        pthread_mutex_unlock(&g_sh->out_mtx[my_id]);
+static int out_drain_to_socket(int my_id, int client_fd) {
+    // Drain everything currently queued for this player; -1 once a send fails
+    int rc = 0, h;
+    while ((h = out_dequeue(my_id)) >= 0) {
+        if (rc == 0 && out_msg_send(client_fd, h) < 0) rc = -1;
+        out_msg_release(h);
         sem_post(&g_sh->out_spaces[my_id]);
+    }
+    return rc;
+}
 
-        // send as a line so client receives it cleanly
-        send_line(client_fd, msg);
+// Drops whatever is queued for a player (a slot being taken over)
+static void out_discard(int id) {
+    int h;
+    while ((h = out_dequeue(id)) >= 0) {
+        out_msg_release(h);
+        sem_post(&g_sh->out_spaces[id]);
     }
 }
 
@@ -419,17 +1099,156 @@ static void *logger_thread_main(void *arg) {
     return NULL;
 }
 
+// ---------- Automatic wordmaster (--auto) ----------
+// Built once before any game: every dictionary word of the room's length,
+// ranked easiest first and cut into AUTO_BUCKETS equal slices. A game's
+// secret is then a bucket and an index. With rank.idx the order is the one
+// wordrank measured by playing bots against each word; without it, words are
+// ranked by how common their distinct letters are across the dictionary
+// (common letters get PRESENT/CORRECT sooner, so they play easier).
+typedef struct {
+    uint64_t **out;
+    uint32_t letter_words[ENGINE_ALPHABET];   // words containing each letter
+    int len;
+} auto_build_t;
+
+typedef struct {
+    uint64_t key;
+    uint32_t ease;
+} auto_ranked_t;
+
+static void auto_collect_word(const char *w, void *ctx) {
+    auto_build_t *b = (auto_build_t*)ctx;
+    int ok;
+    *(*b->out)++ = dict_pack(w, b->len, &ok);
+
+    uint32_t seen = 0;
+    for (int i = 0; i < b->len; i++) seen |= 1u << (w[i] - 'A');
+    for (int l = 0; l < ENGINE_ALPHABET; l++) b->letter_words[l] += (seen >> l) & 1u;
+}
+
+static int auto_ranked_cmp(const void *a, const void *b) {
+    const auto_ranked_t *x = (const auto_ranked_t*)a;
+    const auto_ranked_t *y = (const auto_ranked_t*)b;
+    if (x->ease != y->ease) return (x->ease > y->ease) ? -1 : 1;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+// rank.idx order, keeping only words the current dictionary still has
+static int auto_pool_from_rank(int len, const rank_rec_t *recs, uint64_t nrecs) {
+    uint64_t *words = malloc((size_t)nrecs * sizeof(*words));
+    float *guesses = malloc((size_t)nrecs * sizeof(*guesses));
+    if (!words || !guesses) { free(words); free(guesses); return -1; }
+
+    size_t n = 0;
+    char w[MAX_WORD_LEN + 1];
+    for (uint64_t i = 0; i < nrecs; i++) {
+        uint64_t v = recs[i].key - 1;
+        for (int k = 0; k < len; k++) w[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+        if (!dict_contains(&g_dict, w, len)) continue;
+        guesses[n] = recs[i].mean_guesses;
+        words[n++] = recs[i].key;
+    }
+    if (n < AUTO_BUCKETS) { free(words); free(guesses); return -1; }
+
+    g_auto.words = words;
+    g_auto.n = n;
+    for (int k = 0; k <= AUTO_BUCKETS; k++) g_auto.bucket_start[k] = n * (size_t)k / AUTO_BUCKETS;
+    for (int k = 0; k < AUTO_BUCKETS; k++) g_auto.bucket_guesses[k] = guesses[g_auto.bucket_start[k + 1] - 1];
+    free(guesses);
+    return 0;
+}
+
+static int auto_pool_build(int len) {
+    size_t cap = (size_t)dict_count(&g_dict, len);
+    if (cap == 0) return -1;
+
+    uint64_t nrecs;
+    const rank_rec_t *recs = rank_section(&g_rank, len, &nrecs);
+    if (recs && auto_pool_from_rank(len, recs, nrecs) == 0) return 0;
+
+    uint64_t *words = malloc(cap * sizeof(*words));
+    auto_ranked_t *ranked = malloc(cap * sizeof(*ranked));
+    if (!words || !ranked) { free(words); free(ranked); return -1; }
+
+    uint64_t *end = words;
+    auto_build_t b = { .out = &end, .len = len };
+    dict_foreach(&g_dict, len, auto_collect_word, &b);
+    size_t n = (size_t)(end - words);
+    if (n < AUTO_BUCKETS) { free(words); free(ranked); return -1; }     // every bucket non-empty
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = words[i] - 1;
+        uint32_t seen = 0, ease = 0;
+        for (int k = 0; k < len; k++) seen |= 1u << ((v >> (5 * k)) & 31u);
+        for (int l = 0; l < ENGINE_ALPHABET; l++) {
+            if ((seen >> l) & 1u) ease += b.letter_words[l];
+        }
+        ranked[i].key = words[i];
+        ranked[i].ease = ease;
+    }
+    qsort(ranked, n, sizeof(*ranked), auto_ranked_cmp);
+    for (size_t i = 0; i < n; i++) words[i] = ranked[i].key;
+    free(ranked);
+
+    g_auto.words = words;
+    g_auto.n = n;
+    for (int k = 0; k <= AUTO_BUCKETS; k++) g_auto.bucket_start[k] = n * (size_t)k / AUTO_BUCKETS;
+    return 0;
+}
+
+static uint64_t auto_rand(void) {
+    uint64_t x = g_auto.rng;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    return g_auto.rng = x;
+}
+
+// O(1): uniform bucket (unless one was fixed), then uniform word in it.
+// The pool holds at least AUTO_BUCKETS words, so no bucket is empty.
+// out gets len letters + NUL; returns the bucket drawn from.
+static int auto_pick_word(char *out, int len) {
+    int bucket = g_auto.bucket < 0 ? (int)(auto_rand() % AUTO_BUCKETS) : g_auto.bucket;
+    size_t lo = g_auto.bucket_start[bucket], hi = g_auto.bucket_start[bucket + 1];
+
+    uint64_t v = g_auto.words[lo + auto_rand() % (hi - lo)] - 1;
+    for (int k = 0; k < len; k++) out[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+    out[len] = '\0';
+    return bucket;
+}
+
 // ---------- Scheduler thread (Round Robin turns for guessers) ----------
+static void start_game_locked(const char *w) {
+    // game_mtx must be held; w already validated for this room
+    engine_new_game(&g_sh->game, w, g_sh->word_len);
+    g_sh->current_turn = g_sh->game.turn;
+    g_sh->guess_count_for_pos = 0;
+    g_sh->phase = PHASE_IN_PROGRESS;
+    memset(&g_sh->cur_game, 0, sizeof(g_sh->cur_game));
+    if (g_sh->word_len == ARC_WORD_LEN && !g_sh->word_rules) g_sh->cur_game.head = arc_pack_word(w);
+
+    rec_event_t e = { .type = REC_GAME };
+    memcpy(e.word, w, (size_t)g_sh->word_len);
+    record_append(&e);
+}
+
 static void reset_game_state_locked(void) {
     // game_mtx must be held
-    g_sh->position_idx = 0;
     g_sh->guess_count_for_pos = 0;
-    g_sh->score[1] = 0;
-    g_sh->score[2] = 0;
-    for (int i = 0; i < WORD_LEN; i++) g_sh->display[i] = '_';
-    g_sh->display[WORD_LEN] = '\0';
+    engine_new_game(&g_sh->game, NULL, g_sh->word_len);
     g_sh->current_turn = 0; // will be set when starting
-    g_sh->pass_num = 0;
+}
+
+// game_mtx must be held. A slot is held while connected or inside its
+// grace period; a room is short once a slot it needs is neither.
+static int slot_held_locked(int i) {
+    return g_sh->connected[i] || g_sh->grace_until_ms[i] != 0;
+}
+
+static int room_short_locked(void) {
+    for (int i = g_sh->auto_word ? 1 : 0; i < MAX_PLAYERS; i++) {
+        if (!slot_held_locked(i)) return 1;
+    }
+    return 0;
 }
 
 static void *scheduler_thread_main(void *arg) {
@@ -438,15 +1257,25 @@ static void *scheduler_thread_main(void *arg) {
     while (!g_sh->shutting_down) {
         pthread_mutex_lock(&g_sh->game_mtx);
 
-        // Wait until 3 players connected
+        // Dropped sessions not resumed in time give their slot up
+        uint64_t now_ms = mono_ms();
+        for (int i = 0; i < MAX_PLAYERS; i++) {
+            if (g_sh->grace_until_ms[i] && now_ms >= g_sh->grace_until_ms[i]) {
+                g_sh->grace_until_ms[i] = 0;
+                g_sh->session_token[i] = 0;
+                log_enqueuef("Player %d did not resume in time; slot %d is free.", i, i);
+            }
+        }
+
+        // Wait until 3 players connected (2 guessers with --auto)
         if (g_sh->phase == PHASE_WAITING_PLAYERS) {
-            if (g_sh->connected[0] && g_sh->connected[1] && g_sh->connected[2]) {
+            if ((g_sh->connected[0] || g_sh->auto_word) && g_sh->connected[1] && g_sh->connected[2]) {
                 g_sh->phase = PHASE_WAITING_WORD;
                 g_sh->game_number++;
                 log_enqueuef("All players connected. Starting game #%d. Waiting for wordmaster.", g_sh->game_number);
                 g_sh->current_turn = 0;
                 g_sh->guess_count_for_pos = 0; // scheduler gate
-                sem_post(&g_sh->turn_sem[0]);  // wake wordmaster
+                if (!g_sh->auto_word) sem_post(&g_sh->turn_sem[0]);  // wake wordmaster
             }
             pthread_mutex_unlock(&g_sh->game_mtx);
             usleep(10 * 1000);
@@ -455,6 +1284,22 @@ static void *scheduler_thread_main(void *arg) {
 
         // Waiting for wordmaster to set secret word
         if (g_sh->phase == PHASE_WAITING_WORD) {
+            if (room_short_locked()) {
+                g_sh->phase = PHASE_WAITING_PLAYERS;
+                g_sh->game_number--;    // counted again when the room is full
+                log_enqueuef("A player left for good. Waiting for players.");
+                pthread_mutex_unlock(&g_sh->game_mtx);
+                continue;
+            }
+            if (g_sh->auto_word && g_sh->connected[1] && g_sh->connected[2]) {
+                char w[MAX_WORD_LEN + 1];
+                int bucket = auto_pick_word(w, g_sh->word_len);
+                start_game_locked(w);
+                log_enqueuef("Server picked a %s secret word for game #%d.",
+                             g_auto_bucket_names[bucket], g_sh->game_number);
+                pthread_mutex_unlock(&g_sh->game_mtx);
+                continue;   // first turn goes out on the next pass, no sleep
+            }
             pthread_mutex_unlock(&g_sh->game_mtx);
             usleep(10 * 1000);
             continue;
@@ -462,13 +1307,21 @@ static void *scheduler_thread_main(void *arg) {
 
         // In progress: one guess per position, alternating turns
         if (g_sh->phase == PHASE_IN_PROGRESS) {
-            if (!g_sh->connected[1] || !g_sh->connected[2]) {
+            if (!slot_held_locked(1) || !slot_held_locked(2)) {
                 g_sh->phase = PHASE_GAME_OVER;
+                rec_event_t e = { .type = REC_ABORT };
+                record_append(&e);
                 log_enqueuef("A guesser disconnected. Ending game #%d.", g_sh->game_number);
                 pthread_mutex_unlock(&g_sh->game_mtx);
                 usleep(10 * 1000);
                 continue;
             }
+            if (!g_sh->connected[1] || !g_sh->connected[2]) {
+                // A guesser dropped but may still resume: hold the game
+                pthread_mutex_unlock(&g_sh->game_mtx);
+                usleep(10 * 1000);
+                continue;
+            }
 
             // gate: post exactly once per turn
             if (g_sh->guess_count_for_pos == 0) {
@@ -477,9 +1330,9 @@ static void *scheduler_thread_main(void *arg) {
                 g_sh->current_turn = next;
                 g_sh->guess_count_for_pos = 1;
 
-                log_enqueuef("Turn: player %d (pass=%d/5 pos=%d display=%s scoreA=%d scoreB=%d)",
-                             next, g_sh->pass_num + 1, g_sh->position_idx + 1,
-                             g_sh->display, g_sh->score[1], g_sh->score[2]);
+                log_enqueuef("Turn: player %d (pass=%d/%d pos=%d display=%s scoreA=%d scoreB=%d)",
+                             next, g_sh->game.pass + 1, ENGINE_MAX_PASSES, g_sh->game.pos + 1,
+                             g_sh->game.display, g_sh->game.score[1], g_sh->game.score[2]);
 
                 sem_post(&g_sh->turn_sem[next]);
             }
@@ -491,14 +1344,27 @@ static void *scheduler_thread_main(void *arg) {
 
         // Game over: reset and ask wordmaster for next game
         if (g_sh->phase == PHASE_GAME_OVER) {
+            stats_merge_room_locked();
             reset_game_state_locked();
-            g_sh->secret_word[0] = '\0';
+            if (room_short_locked()) {
+                g_sh->phase = PHASE_WAITING_PLAYERS;
+                log_enqueuef("Reset complete. Waiting for players.");
+                pthread_mutex_unlock(&g_sh->game_mtx);
+                usleep(10 * 1000);
+                continue;
+            }
             g_sh->phase = PHASE_WAITING_WORD;
             g_sh->current_turn = 0;
             g_sh->guess_count_for_pos = 0;
-            log_enqueuef("Reset complete. Waiting for wordmaster for game #%d.", g_sh->game_number + 1);
-            sem_post(&g_sh->turn_sem[0]);
+            g_sh->game_number++;
+            log_enqueuef("Reset complete. %s for game #%d.",
+                         g_sh->auto_word ? "Waiting for both guessers" : "Waiting for wordmaster",
+                         g_sh->game_number);
+            if (!g_sh->auto_word) sem_post(&g_sh->turn_sem[0]);
             pthread_mutex_unlock(&g_sh->game_mtx);
+
+            // Flush merged stats outside game_mtx, every few games
+            if (g_sh->stats_dirty_games >= STATS_FLUSH_EVERY) stats_save(STATS_PATH);
             usleep(10 * 1000);
             continue;
         }
@@ -510,15 +1376,140 @@ static void *scheduler_thread_main(void *arg) {
     return NULL;
 }
 
+// ---------- Resumable sessions ----------
+// NAME claims a free slot and gets a SESSION token. When the socket drops
+// the slot stays reserved for --grace seconds (the scheduler holds a game
+// in progress meanwhile); RESUME <token> from a new connection takes it
+// back, even before the old child has noticed the drop: the old child is
+// signalled and leaves without touching the slot. The resumed client gets
+// ROLE and one RESUMED line (display, scores, pass, position, turn) instead
+// of the broadcasts it missed.
+
+static void session_superseded(int signo) {
+    (void)signo;
+    g_superseded = 1;
+}
+
+static int session_owned(int player_id) {
+    return g_sh->session_pid[player_id] == getpid();
+}
+
+static uint64_t session_new_token(void) {
+    uint64_t t = 0;
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd >= 0) {
+        if (read(fd, &t, sizeof(t)) != (ssize_t)sizeof(t)) t = 0;
+        close(fd);
+    }
+    if (t == 0) {
+        // splitmix64 over the clock and pid: unique, if not secret
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        t = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 16);
+        t += 0x9E3779B97F4A7C15ull;
+        t = (t ^ (t >> 30)) * 0xBF58476D1CE4E5B9ull;
+        t = (t ^ (t >> 27)) * 0x94D049BB133111EBull;
+        t ^= t >> 31;
+    }
+    return t ? t : 1;
+}
+
+// game_mtx must be held. The calling child now serves player_id: clear
+// turn wake-ups and broadcasts meant for the previous connection, then
+// re-arm a prompt that is due so the scheduler or this child reissues it.
+static void session_attach_locked(int player_id) {
+    g_sh->connected[player_id] = 1;
+    g_sh->session_pid[player_id] = getpid();
+    g_sh->binary[player_id] = g_binary;
+    g_sh->grace_until_ms[player_id] = 0;
+    while (sem_trywait(&g_sh->turn_sem[player_id]) == 0) { }
+    out_discard(player_id);
+    if (player_id == 0) {
+        if (g_sh->phase == PHASE_WAITING_WORD) sem_post(&g_sh->turn_sem[0]);
+    } else if (g_sh->phase == PHASE_IN_PROGRESS && g_sh->current_turn == player_id) {
+        g_sh->guess_count_for_pos = 0;
+    }
+    rec_event_t join = { .type = REC_JOIN, .player = (uint8_t)player_id };
+    record_append(&join);
+}
+
+// NAME: the lowest free slot (guessers only with --auto), or -1 if the room is full
+static int session_claim(const char *name, uint64_t *token) {
+    pthread_mutex_lock(&g_sh->game_mtx);
+    int slot = -1;
+    for (int i = g_sh->auto_word ? 1 : 0; i < MAX_PLAYERS && slot < 0; i++) {
+        if (g_sh->session_token[i] == 0 && !g_sh->connected[i]) slot = i;
+    }
+    if (slot >= 0) {
+        *token = g_sh->session_token[slot] = session_new_token();
+        snprintf(g_sh->player_name[slot], NAME_LEN, "%s", name);
+        session_attach_locked(slot);
+    }
+    pthread_mutex_unlock(&g_sh->game_mtx);
+    return slot;
+}
+
+// RESUME: the slot holding token, or -1 if none does (unknown or expired).
+// snap receives the RESUMED line.
+static int session_resume(uint64_t token, char *snap, size_t cap) {
+    pthread_mutex_lock(&g_sh->game_mtx);
+    int slot = -1;
+    for (int i = 0; i < MAX_PLAYERS && token; i++) {
+        if (g_sh->session_token[i] == token) slot = i;
+    }
+    pid_t old = 0;
+    if (slot >= 0) {
+        old = g_sh->session_pid[slot];
+        session_attach_locked(slot);
+
+        engine_snapshot_t v;
+        engine_snapshot(&g_sh->game, &v);
+        snprintf(snap, cap, "RESUMED pass=%d/%d pos=%d display=%s scoreA=%d scoreB=%d turn=%d",
+                 v.pass + 1, ENGINE_MAX_PASSES, v.pos + 1, v.display, v.score_a, v.score_b,
+                 g_sh->phase == PHASE_IN_PROGRESS ? v.turn : 0);
+    }
+    pthread_mutex_unlock(&g_sh->game_mtx);
+    if (old > 0 && old != getpid()) kill(old, SIGUSR2);    // still blocked on the dead socket
+    return slot;
+}
+
+// The child's connection ended: hold the slot for --grace, or free it
+static void session_drop(int player_id) {
+    pthread_mutex_lock(&g_sh->game_mtx);
+    if (!session_owned(player_id)) {
+        pthread_mutex_unlock(&g_sh->game_mtx);
+        log_enqueuef("Player %d's previous connection closed (resumed).", player_id);
+        return;
+    }
+    g_sh->connected[player_id] = 0;
+    g_sh->session_pid[player_id] = 0;
+    if (player_id != 0) g_sh->guess_count_for_pos = 0;     // release scheduler gate
+    int grace_ms = g_sh->shutting_down ? 0 : g_sh->grace_ms;
+    if (grace_ms > 0) g_sh->grace_until_ms[player_id] = mono_ms() + (uint64_t)grace_ms;
+    else g_sh->session_token[player_id] = 0;
+    rec_event_t leave = { .type = REC_LEAVE, .player = (uint8_t)player_id };
+    record_append(&leave);
+    pthread_mutex_unlock(&g_sh->game_mtx);
+
+    if (grace_ms > 0) log_enqueuef("Player %d disconnected; slot held %d s for RESUME.", player_id, grace_ms / 1000);
+    else log_enqueuef("Player %d disconnected.", player_id);
+}
+
 // ---------- Child session handlers ----------
 static int is_valid_word(const char *w) {
-    if ((int)strlen(w) != WORD_LEN) return 0;
-    for (int i = 0; i < WORD_LEN; i++) {
+    if ((int)strlen(w) != g_sh->word_len) return 0;
+    for (int i = 0; i < g_sh->word_len; i++) {
         if (w[i] < 'A' || w[i] > 'Z') return 0;
     }
     return 1;
 }
 
+static int is_dictionary_word(const char *w) {
+    // Without dict.idx (or without words of this length) any A-Z word goes
+    if (dict_count(&g_dict, g_sh->word_len) == 0) return 1;
+    return dict_contains(&g_dict, w, g_sh->word_len);
+}
+
 static int parse_name(const char *line, char *out, size_t cap) {
     // expects: "NAME <token>"
     if (strncmp(line, "NAME ", 5) != 0) return -1;
@@ -528,19 +1519,39 @@ static int parse_name(const char *line, char *out, size_t cap) {
     return 0;
 }
 
-static int is_word_revealed_locked(void) {
-    // game_mtx must be held
-    for (int i = 0; i < WORD_LEN; i++) {
-        if (g_sh->display[i] == '_') return 0;
+// ROLE and YOUR_TURN go only to this child's client: a frame or the line
+static int send_role(int fd, const wire_role_t *r) {
+    if (g_binary) {
+        uint8_t f[WIRE_MAX_FRAME];
+        return send_frame(fd, f, wire_put_role(f, r));
     }
-    return 1;
+    char line[128];
+    wire_text_role(line, sizeof(line), r);
+    return send_line(fd, line);
 }
 
-static void child_wordmaster_loop(int client_fd, int player_id) {
+static int send_turn(int fd, const wire_turn_t *t) {
+    if (g_binary) {
+        uint8_t f[WIRE_MAX_FRAME];
+        return send_frame(fd, f, wire_put_turn(f, t));
+    }
+    char line[256];
+    wire_text_turn(line, sizeof(line), t);
+    return send_line(fd, line);
+}
+
+static void child_wordmaster_loop(int client_fd, int player_id, const char *resumed) {
     (void)player_id;
 
-    send_line(client_fd, "ROLE WORDMASTER");
-    send_line(client_fd, "INFO You will enter a 5-letter secret word (A-Z).");
+    char msg[128];
+    wire_role_t role = { .player = 0, .len = g_sh->word_len };
+    send_role(client_fd, &role);
+    if (resumed) {
+        send_line(client_fd, resumed);
+    } else {
+        snprintf(msg, sizeof(msg), "INFO You will enter a %d-letter secret word (A-Z).", g_sh->word_len);
+        send_line(client_fd, msg);
+    }
 
     while (1) {
         // Block until scheduler signals it's time to enter word
@@ -548,9 +1559,9 @@ static void child_wordmaster_loop(int client_fd, int player_id) {
         // if (g_sh->shutting_down) break;
 
         while (1) {
-            if (g_sh->shutting_down) return;
+            if (g_sh->shutting_down || !session_owned(0)) return;
 
-            out_drain_to_socket(0, client_fd);
+            if (out_drain_to_socket(0, client_fd) < 0 || peer_closed(client_fd)) return;
 
             if (sem_trywait(&g_sh->turn_sem[0]) == 0) {
                 break;
@@ -560,7 +1571,7 @@ static void child_wordmaster_loop(int client_fd, int player_id) {
         }
 
         pthread_mutex_lock(&g_sh->game_mtx);
-        if (!g_sh->connected[0]) {
+        if (!session_owned(0)) {
             pthread_mutex_unlock(&g_sh->game_mtx);
             break;
         }
@@ -570,49 +1581,54 @@ static void child_wordmaster_loop(int client_fd, int player_id) {
         }
         pthread_mutex_unlock(&g_sh->game_mtx);
 
-        send_line(client_fd, "ENTER_WORD Please send: WORD ABCDE");
+        snprintf(msg, sizeof(msg), "ENTER_WORD Please send: WORD %.*s", g_sh->word_len, "ABCDEFGHIJKL");
+        send_line(client_fd, msg);
 
         // Receive until valid WORD
         while (1) {
             char line[256];
             ssize_t r = recv_line(client_fd, line, sizeof(line));
-            if (r <= 0) {
-                pthread_mutex_lock(&g_sh->game_mtx);
-                g_sh->connected[0] = 0;
-                pthread_mutex_unlock(&g_sh->game_mtx);
-                log_enqueuef("Wordmaster disconnected.");
-                return;
-            }
+            if (r <= 0) return;
 
             if (strncmp(line, "WORD ", 5) == 0) {
-                char w[WORD_LEN + 1];
-                snprintf(w, sizeof(w), "%s", line + 5);
+                char w[MAX_WORD_LEN + 2];   // one spare so overlong words fail validation
+                snprintf(w, sizeof(w), "%.*s", MAX_WORD_LEN + 1, line + 5);
 
                 // Uppercase normalize
-                for (int i = 0; i < WORD_LEN; i++) {
+                for (int i = 0; w[i]; i++) {
                     if (w[i] >= 'a' && w[i] <= 'z') w[i] = (char)(w[i] - 'a' + 'A');
                 }
 
                 if (!is_valid_word(w)) {
-                    send_line(client_fd, "ERR Word must be exactly 5 letters A-Z. Try again.");
+                    snprintf(msg, sizeof(msg), "ERR Word must be exactly %d letters A-Z. Try again.", g_sh->word_len);
+                    send_line(client_fd, msg);
+                    continue;
+                }
+                if (!is_dictionary_word(w)) {
+                    send_line(client_fd, "ERR Word is not in the dictionary. Try again.");
                     continue;
                 }
 
                 pthread_mutex_lock(&g_sh->game_mtx);
-                strncpy(g_sh->secret_word, w, WORD_LEN);
-                g_sh->secret_word[WORD_LEN] = '\0';
-                g_sh->position_idx = 0;
-                g_sh->pass_num = 0;
-                g_sh->current_turn = 1;
-                g_sh->guess_count_for_pos = 0;
-                g_sh->phase = PHASE_IN_PROGRESS;
+                if (!session_owned(0)) {
+                    pthread_mutex_unlock(&g_sh->game_mtx);
+                    return;
+                }
+                if (g_sh->phase != PHASE_WAITING_WORD) {
+                    // A guesser left for good while the word was being typed
+                    pthread_mutex_unlock(&g_sh->game_mtx);
+                    send_line(client_fd, "INFO Waiting for players; you will be asked for a word again.");
+                    break;
+                }
+                start_game_locked(w);
                 log_enqueuef("Wordmaster set secret word for game #%d.", g_sh->game_number);
                 pthread_mutex_unlock(&g_sh->game_mtx);
 
                 send_line(client_fd, "OK Word accepted. Game started.");
                 break;
             } else {
-                send_line(client_fd, "ERR Expected: WORD ABCDE");
+                snprintf(msg, sizeof(msg), "ERR Expected: WORD %.*s", g_sh->word_len, "ABCDEFGHIJKL");
+                send_line(client_fd, msg);
             }
         }
     }
@@ -625,18 +1641,27 @@ static void broadcast_state_to_guessers(int fd1, int fd2) {
     (void)fd1; (void)fd2;
 }
 
-static void child_guesser_loop(int client_fd, int player_id) {
-    char role_msg[64];
-    snprintf(role_msg, sizeof(role_msg), "ROLE GUESSER %d", player_id);
-    send_line(client_fd, role_msg);
-    send_line(client_fd, "INFO You will guess letters (A-Z) for each position 1..5 when prompted: GUESS X");
+static void child_guesser_loop(int client_fd, int player_id, const char *resumed) {
+    char role_msg[128];
+    int word_rules = g_sh->word_rules;
+    wire_role_t role = { .player = player_id, .len = g_sh->word_len, .word_rules = word_rules };
+    send_role(client_fd, &role);
+    if (word_rules) {
+        snprintf(role_msg, sizeof(role_msg),
+                 "INFO You will guess a whole %d-letter dictionary word each turn: GUESSWORD %.*s",
+                 g_sh->word_len, g_sh->word_len, "ABCDEFGHIJKL");
+    } else {
+        snprintf(role_msg, sizeof(role_msg),
+                 "INFO You will guess letters (A-Z) for each position 1..%d when prompted: GUESS X", g_sh->word_len);
+    }
+    send_line(client_fd, resumed ? resumed : role_msg);
 
     while (1) {
         // Wait for our turn, but keep flushing broadcast messages while waiting
         while (1) {
-            if (g_sh->shutting_down) return;
+            if (g_sh->shutting_down || !session_owned(player_id)) return;
 
-            out_drain_to_socket(player_id, client_fd);
+            if (out_drain_to_socket(player_id, client_fd) < 0 || peer_closed(client_fd)) return;
 
             if (sem_trywait(&g_sh->turn_sem[player_id]) == 0) {
                 break; // our turn
@@ -645,7 +1670,7 @@ static void child_guesser_loop(int client_fd, int player_id) {
         }
 
         pthread_mutex_lock(&g_sh->game_mtx);
-        if (!g_sh->connected[player_id]) {
+        if (!session_owned(player_id)) {
             pthread_mutex_unlock(&g_sh->game_mtx);
             break;
         }
@@ -655,41 +1680,44 @@ static void child_guesser_loop(int client_fd, int player_id) {
             continue;
         }
 
-        int pos = g_sh->position_idx;
-        int pass = g_sh->pass_num;
-        char disp[WORD_LEN + 1];
-        strncpy(disp, g_sh->display, WORD_LEN);
-        disp[WORD_LEN] = '\0';
+        engine_snapshot_t view;
+        engine_snapshot(&g_sh->game, &view);
         pthread_mutex_unlock(&g_sh->game_mtx);
 
-        char prompt[256];
-        snprintf(prompt, sizeof(prompt),
-                 "YOUR_TURN pass=%d/5 pos=%d display=%s (send: GUESS X)", pass + 1, pos + 1, disp);
-        if (send_line(client_fd, prompt) < 0) {
-            pthread_mutex_lock(&g_sh->game_mtx);
-            g_sh->connected[player_id] = 0;
-            // release scheduler gate
-            g_sh->guess_count_for_pos = 0;
-            pthread_mutex_unlock(&g_sh->game_mtx);
+        wire_turn_t turn = { .pass = view.pass + 1, .pos = view.pos + 1, .word_rules = word_rules };
+        memcpy(turn.display, view.display, sizeof(turn.display));
+        if (send_turn(client_fd, &turn) < 0) {
             log_enqueuef("Player %d disconnected during prompt.", player_id);
-            return;
+            return;     // child_session releases the scheduler gate
         }
+        uint64_t prompt_ms = mono_ms();
 
         // Read until valid GUESS line (so scheduler doesn't deadlock)
         char line[256];
         char ch = '\0';
+        char word[MAX_WORD_LEN + 2];   // GUESSWORD; one spare so overlong words fail validation
         while (1) {
             ssize_t r = recv_line(client_fd, line, sizeof(line));
-            if (r <= 0) {
-                pthread_mutex_lock(&g_sh->game_mtx);
-                g_sh->connected[player_id] = 0;
-                g_sh->guess_count_for_pos = 0;
-                pthread_mutex_unlock(&g_sh->game_mtx);
-                log_enqueuef("Player %d disconnected.", player_id);
-                return;
-            }
+            if (r <= 0) return;
 
-            if (strncmp(line, "GUESS ", 6) == 0 && strlen(line + 6) >= 1) {
+            if (word_rules && strncmp(line, "GUESSWORD ", 10) == 0) {
+                snprintf(word, sizeof(word), "%.*s", MAX_WORD_LEN + 1, line + 10);
+                for (int i = 0; word[i]; i++) {
+                    if (word[i] >= 'a' && word[i] <= 'z') word[i] = (char)(word[i] - 'a' + 'A');
+                }
+                char err[96];
+                if (!is_valid_word(word)) {
+                    snprintf(err, sizeof(err), "ERR Guess must be exactly %d letters A-Z.", g_sh->word_len);
+                    send_line(client_fd, err);
+                    continue;
+                }
+                if (!is_dictionary_word(word)) {
+                    send_line(client_fd, "ERR Word is not in the dictionary.");
+                    continue;
+                }
+                break;
+            }
+            if (!word_rules && strncmp(line, "GUESS ", 6) == 0 && strlen(line + 6) >= 1) {
                 ch = line[6];
                 if (ch >= 'a' && ch <= 'z') ch = (char)(ch - 'a' + 'A');
                 if (ch >= 'A' && ch <= 'Z') break;
@@ -697,13 +1725,24 @@ static void child_guesser_loop(int client_fd, int player_id) {
                 continue;
             }
 
-            send_line(client_fd, "ERR Expected: GUESS X");
+            if (word_rules) {
+                char err[64];
+                snprintf(err, sizeof(err), "ERR Expected: GUESSWORD %.*s", g_sh->word_len, "ABCDEFGHIJKL");
+                send_line(client_fd, err);
+            } else {
+                send_line(client_fd, "ERR Expected: GUESS X");
+            }
         }
+        uint64_t think_ms = mono_ms() - prompt_ms;
 
         // Apply guess to shared state (one guess per position)
         pthread_mutex_lock(&g_sh->game_mtx);
 
-        // Re-check still valid
+        // Re-check still valid (and still ours: a RESUME may have taken the slot)
+        if (!session_owned(player_id)) {
+            pthread_mutex_unlock(&g_sh->game_mtx);
+            return;
+        }
         if (g_sh->phase != PHASE_IN_PROGRESS || g_sh->current_turn != player_id) {
             pthread_mutex_unlock(&g_sh->game_mtx);
             send_line(client_fd, "ERR Not your turn (race).");
@@ -714,112 +1753,187 @@ static void child_guesser_loop(int client_fd, int player_id) {
             continue;
         }
 
-        int pass_before = g_sh->pass_num;
-        int pos_before  = g_sh->position_idx;
-
-        int correct = (ch == g_sh->secret_word[pos_before]) ? 1 : 0;
-        int present = 0;
-        if (!correct) {
-            for (int k = 0; k < WORD_LEN; k++) {
-                if (g_sh->secret_word[k] == ch) { present = 1; break; }
+        room_stats_t *rs = &g_sh->room_stats[player_id];
+        rs->think_ms += think_ms;
+        int is_game_over;
+        int pass_before;
+        int pos_before = 0;
+        const char *result = NULL;
+        int result_code = 0;
+        char feedback[MAX_WORD_LEN + 1];   // word rules: C/P/A per position
+        int gained = 0;
+
+        if (word_rules) {
+            engine_word_move_t wm;
+            engine_apply_word(&g_sh->game, word, &wm);
+            rec_event_t ev = { .type = REC_GUESSWORD, .player = (uint8_t)player_id,
+                               .result = (uint8_t)wm.revealed };
+            memcpy(ev.word, word, (size_t)g_sh->word_len);
+            record_append(&ev);
+            is_game_over = wm.over;
+            pass_before = wm.pass;
+            gained = wm.revealed;
+
+            // Every position of the word counts as one guess in the stats
+            for (int i = 0; i < g_sh->word_len; i++) {
+                engine_result_t r = ENGINE_FEEDBACK_AT(wm.feedback, i);
+                feedback[i] = "APC"[r];
+                rs->guesses += 1;
+                rs->pos_guesses[i] += 1;
+                if (r == ENGINE_CORRECT) { rs->correct += 1; rs->pos_correct[i] += 1; }
+                else if (r == ENGINE_PRESENT) rs->present += 1;
+                else rs->absent += 1;
+            }
+            feedback[g_sh->word_len] = '\0';
+        } else {
+            engine_move_t mv;
+            engine_apply_guess(&g_sh->game, ch, &mv);
+            rec_event_t ev = { .type = REC_GUESS, .player = (uint8_t)player_id,
+                               .letter = (uint8_t)ch, .result = (uint8_t)mv.result };
+            record_append(&ev);
+            is_game_over = mv.over;
+            pass_before = mv.pass;
+            pos_before  = mv.pos;
+            result = engine_result_name(mv.result);
+            result_code = (int)mv.result;
+
+            rs->guesses += 1;
+            rs->pos_guesses[pos_before] += 1;
+            if (mv.result == ENGINE_CORRECT) { rs->correct += 1; rs->pos_correct[pos_before] += 1; }
+            else if (mv.result == ENGINE_PRESENT) rs->present += 1;
+            else rs->absent += 1;
+
+            // Archive records pack a 5-letter word; other room lengths are not archived
+            arc_game_t *ag = &g_sh->cur_game;
+            int ng = arc_nguesses(ag);
+            if (g_sh->word_len == ARC_WORD_LEN && ng < ARC_MAX_GUESSES) {
+                ag->guess[ng] = arc_pack_guess(ch, (int)mv.result, player_id);
+                ag->think_ms[ng] = (uint16_t)(think_ms > 65535 ? 65535 : think_ms);
+                ag->head = (ag->head & ~(31u << 25)) | ((uint32_t)(ng + 1) << 25);
             }
-        }
-        const char *result = correct ? "CORRECT" : (present ? "PRESENT" : "ABSENT");
-
-        if (correct) {
-            g_sh->score[player_id] += 1;
-            g_sh->display[pos_before] = g_sh->secret_word[pos_before];
-        }
-
-        // Advance immediately (one guess per position)
-        g_sh->position_idx += 1;
-        if (g_sh->position_idx >= WORD_LEN) {
-            g_sh->position_idx = 0;
-            g_sh->pass_num += 1;
         }
 
         // Determine end of game
-        if (is_word_revealed_locked() || g_sh->pass_num >= 5) {
+        if (is_game_over) {
             g_sh->phase = PHASE_GAME_OVER;
         } else {
-            // Swap turn
-            g_sh->current_turn = (player_id == 1) ? 2 : 1;
+            g_sh->current_turn = g_sh->game.turn;
         }
 
         // Release scheduler gate so it can post next turn (or proceed to reset)
         g_sh->guess_count_for_pos = 0;
 
         // Snapshot state for UI sync
-        char state[256];
-        snprintf(state, sizeof(state),
-                 "STATE from=%d pass=%d/5 pos=%d guess=%c result=%s display=%s scoreA=%d scoreB=%d next_pass=%d/5 next_pos=%d turn=%d",
-                 player_id,
-                 pass_before + 1,
-                 pos_before + 1,
-                 ch,
-                 result,
-                 g_sh->display,
-                 g_sh->score[1],
-                 g_sh->score[2],
-                 (g_sh->pass_num + 1),
-                 (g_sh->position_idx + 1),
-                 (g_sh->phase == PHASE_IN_PROGRESS ? g_sh->current_turn : 0));
-
-        int is_game_over = (g_sh->phase == PHASE_GAME_OVER);
-        int s1 = g_sh->score[1];
-        int s2 = g_sh->score[2];
-        char secret[WORD_LEN + 1];
-        strncpy(secret, g_sh->secret_word, WORD_LEN);
-        secret[WORD_LEN] = '\0';
+        engine_snapshot_t snap;
+        engine_snapshot(&g_sh->game, &snap);
+        wire_state_t st = {
+            .word_rules = word_rules, .from = player_id, .turn = snap.turn,
+            .pass = pass_before + 1, .next_pass = snap.pass + 1,
+            .pos = pos_before + 1, .next_pos = snap.pos + 1, .letter = ch, .result = result_code,
+            .score_a = snap.score_a, .score_b = snap.score_b,
+        };
+        if (word_rules) {
+            snprintf(st.guessword, sizeof(st.guessword), "%.*s", MAX_WORD_LEN, word);
+            memcpy(st.feedback, feedback, sizeof(st.feedback));
+        }
+        memcpy(st.display, snap.display, sizeof(st.display));
+        // Each encoding is built once, and only if a recipient speaks it
+        int other = (player_id == 1) ? 2 : 1;
+        int any_text = !g_binary || !g_sh->binary[other] || (!g_sh->auto_word && !g_sh->binary[0]);
+        int any_binary = g_binary || g_sh->binary[other] || (!g_sh->auto_word && g_sh->binary[0]);
+
+        int s1 = snap.score_a;
+        int s2 = snap.score_b;
+        char secret[MAX_WORD_LEN + 1];
+        memcpy(secret, g_sh->game.secret, sizeof(secret));
+        arc_game_t arc;
+        if (is_game_over) {
+            rec_event_t end = { .type = REC_END, .result = (uint8_t)(s1 > s2 ? 1 : (s2 > s1 ? 2 : 0)),
+                                .score_a = (uint8_t)s1, .score_b = (uint8_t)s2 };
+            record_append(&end);
+            arc = g_sh->cur_game;
+            arc.passes = (uint8_t)snap.pass;
+            if (g_sh->game.revealed == g_sh->word_len) arc.flags |= ARC_FLAG_SOLVED;
+        }
 
         pthread_mutex_unlock(&g_sh->game_mtx);
 
-        // Send state to everyone: self directly, others via queue
-        send_line(client_fd, state);
-        out_enqueue(0, state);
-        out_enqueue((player_id == 1) ? 2 : 1, state);
+        int h = out_msg_new();
+        if (h >= 0) {
+            out_msg_t *m = &g_sh->out_pool[h];
+            if (any_binary) m->flen = (uint16_t)wire_put_state(m->frame, &st);
+            if (any_text) wire_text_state(m->text, OUT_MSG_LEN, &st);
+            out_msg_seal(h);
+        }
 
-        log_enqueuef("Player %d guessed '%c' for pos %d -> %s (scoreA=%d scoreB=%d)",
-                     player_id, ch, pos_before + 1, result, s1, s2);
+        // Send state to everyone: self directly, others via a handle each
+        out_msg_send(client_fd, h);
+        out_enqueue(0, h);
+        out_enqueue(other, h);
+        out_msg_release(h);
+
+        if (word_rules) {
+            log_enqueuef("Player %d guessed %s -> %s, +%d (scoreA=%d scoreB=%d)",
+                         player_id, word, feedback, gained, s1, s2);
+        } else {
+            log_enqueuef("Player %d guessed '%c' for pos %d -> %s (scoreA=%d scoreB=%d)",
+                         player_id, ch, pos_before + 1, result, s1, s2);
+        }
 
         if (is_game_over) {
             int winner = 0;
             if (s1 > s2) winner = 1;
             else if (s2 > s1) winner = 2;
 
-            // Update persistent wins
-            pthread_mutex_lock(&g_sh->score_mtx);
-            if (winner == 1 || winner == 2) {
-                g_sh->score_table[winner].wins += 1;
-                if (g_sh->player_name[winner][0]) {
-                    strncpy(g_sh->score_table[winner].name, g_sh->player_name[winner], NAME_LEN - 1);
-                    g_sh->score_table[winner].name[NAME_LEN - 1] = '\0';
-                }
+            // Update persistent wins and both guessers' ratings
+            const char *name1 = g_sh->player_name[1][0] ? g_sh->player_name[1] : "GuesserA";
+            const char *name2 = g_sh->player_name[2][0] ? g_sh->player_name[2] : "GuesserB";
+            double r1, r2;
+            scores_record_game(name1, name2, winner, &r1, &r2);
+
+            // History line replayed by the rerate tool (format must stay stable)
+            log_enqueuef("Game #%d result: winner=%d A=%s B=%s (ratingA=%.1f ratingB=%.1f)",
+                         g_sh->game_number, winner, name1, name2, r1, r2);
+
+            arc.head = (arc.head & ~(3u << 30)) | ((uint32_t)winner << 30);
+            arc.end_time = (uint32_t)time(NULL);
+            arc.player_a = score_name_hash(name1);
+            arc.player_b = score_name_hash(name2);
+            arc.score_a = (uint8_t)s1;
+            arc.score_b = (uint8_t)s2;
+            if (g_sh->word_len == ARC_WORD_LEN && !word_rules) archive_append(&arc);
+
+            scores_save(SCORES_TXT);
+
+            wire_over_t over = { .passes = snap.pass, .score_a = s1, .score_b = s2, .winner = winner };
+            memcpy(over.word, secret, sizeof(over.word));
+            memcpy(over.display, snap.display, sizeof(over.display));
+            h = out_msg_new();
+            if (h >= 0) {
+                out_msg_t *m = &g_sh->out_pool[h];
+                if (any_binary) m->flen = (uint16_t)wire_put_over(m->frame, &over);
+                if (any_text) wire_text_over(m->text, OUT_MSG_LEN, &over);
+                out_msg_seal(h);
             }
-            pthread_mutex_unlock(&g_sh->score_mtx);
-
-            scores_save("scores.txt");
-
-            char endmsg[256];
-            snprintf(endmsg, sizeof(endmsg),
-                     "GAME_OVER word=%s display=%s passes=%d scoreA=%d scoreB=%d winner=%s",
-                     secret,
-                     g_sh->display,   // safe: display is stable now
-                     g_sh->pass_num,
-                     s1, s2,
-                     (winner == 0 ? "DRAW" : (winner == 1 ? "PLAYER1" : "PLAYER2")));
 
             // Notify everyone of game end
-            send_line(client_fd, endmsg);
-            out_enqueue(0, endmsg);
-            out_enqueue((player_id == 1) ? 2 : 1, endmsg);
+            out_msg_send(client_fd, h);
+            out_enqueue(0, h);
+            out_enqueue(other, h);
+            out_msg_release(h);
         }
     }
 }
 
-static void child_session(int client_fd, int player_id) {
-    // Ask for name first
-    send_line(client_fd, "WELCOME Please identify: NAME yourname");
+static void child_session(int client_fd) {
+    // Without SA_RESTART, so a takeover interrupts a blocked recv()
+    struct sigaction su;
+    memset(&su, 0, sizeof(su));
+    su.sa_handler = session_superseded;
+    sigaction(SIGUSR2, &su, NULL);
+
+    // Ask for name first (or a session token to resume)
+    send_line(client_fd, "WELCOME Please identify: NAME yourname (or RESUME token)" WIRE_HELLO);
 
     char line[256];
     ssize_t r = recv_line(client_fd, line, sizeof(line));
@@ -828,29 +1942,52 @@ static void child_session(int client_fd, int player_id) {
         return;
     }
 
-    char name[NAME_LEN];
-    if (parse_name(line, name, sizeof(name)) != 0) {
-        send_line(client_fd, "ERR Expected: NAME yourname");
-        close(client_fd);
-        return;
+    // A client that wants wire.h frames repeats WIRE_HELLO after its name or
+    // token; everything sent after this line is framed
+    size_t n = strlen(line), hello = strlen(WIRE_HELLO);
+    if (n > hello && strcmp(line + n - hello, WIRE_HELLO) == 0) {
+        line[n - hello] = '\0';
+        g_binary = 1;
     }
 
-    pthread_mutex_lock(&g_sh->game_mtx);
-    g_sh->connected[player_id] = 1;
-    strncpy(g_sh->player_name[player_id], name, NAME_LEN - 1);
-    g_sh->player_name[player_id][NAME_LEN - 1] = '\0';
-    pthread_mutex_unlock(&g_sh->game_mtx);
-
-    log_enqueuef("Player %d connected as '%s'.", player_id, name);
+    int player_id;
+    uint64_t token = 0;
+    char snap[160];
+    const char *resumed = NULL;
+    if (strncmp(line, "RESUME ", 7) == 0) {
+        token = strtoull(line + 7, NULL, 16);
+        player_id = session_resume(token, snap, sizeof(snap));
+        if (player_id < 0) {
+            send_line(client_fd, "ERR Unknown or expired session.");
+            close(client_fd);
+            return;
+        }
+        resumed = snap;
+        log_enqueuef("Player %d resumed as '%s'.", player_id, g_sh->player_name[player_id]);
+    } else {
+        char name[NAME_LEN];
+        if (parse_name(line, name, sizeof(name)) != 0) {
+            send_line(client_fd, "ERR Expected: NAME yourname");
+            close(client_fd);
+            return;
+        }
+        player_id = session_claim(name, &token);
+        if (player_id < 0) {
+            send_line(client_fd, "ERR Room is full.");
+            close(client_fd);
+            return;
+        }
+        log_enqueuef("Player %d connected as '%s'.", player_id, name);
+    }
 
-    if (player_id == 0) child_wordmaster_loop(client_fd, player_id);
-    else child_guesser_loop(client_fd, player_id);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "SESSION token=%016llx grace=%d", (unsigned long long)token, g_sh->grace_ms / 1000);
+    send_line(client_fd, msg);
 
-    pthread_mutex_lock(&g_sh->game_mtx);
-    g_sh->connected[player_id] = 0;
-    pthread_mutex_unlock(&g_sh->game_mtx);
-    log_enqueuef("Player %d disconnected.", player_id);
+    if (player_id == 0) child_wordmaster_loop(client_fd, player_id, resumed);
+    else child_guesser_loop(client_fd, player_id, resumed);
 
+    session_drop(player_id);
     close(client_fd);
 }
 
@@ -881,11 +2018,52 @@ static int make_listen_socket(uint16_t port) {
 
 // ---------- main ----------
 int main(int argc, char **argv) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <port>\nExample: %s 5000\n", argv[0], argv[0]);
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <port> [word_len %d..%d] [--auto[=easy|medium|hard]] [--seed=N]\n"
+                        "          [--record=FILE] [--rules=letter|word] [--grace=SEC]\n"
+                        "Example: %s 5000 5 --auto --record=games.rec\n",
+                argv[0], ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN, argv[0]);
         return 1;
     }
     uint16_t port = (uint16_t)atoi(argv[1]);
+    int word_len = WORD_LEN;
+    int auto_word = 0;
+    int word_rules = 0;
+    int grace_s = 30;
+    const char *record_path = NULL;
+    uint64_t seed = ((uint64_t)time(NULL) << 20) ^ (uint64_t)getpid();
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--record=", 9) == 0) {
+            record_path = argv[i] + 9;
+        } else if (strcmp(argv[i], "--rules=word") == 0 || strcmp(argv[i], "--rules=letter") == 0) {
+            word_rules = (argv[i][8] == 'w');
+        } else if (strncmp(argv[i], "--grace=", 8) == 0) {
+            grace_s = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            seed = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "--auto", 6) == 0) {
+            auto_word = 1;
+            if (argv[i][6] == '=') {
+                g_auto.bucket = -2;
+                for (int k = 0; k < AUTO_BUCKETS; k++) {
+                    if (strcmp(argv[i] + 7, g_auto_bucket_names[k]) == 0) g_auto.bucket = k;
+                }
+            }
+            if (g_auto.bucket == -2 || (argv[i][6] != '\0' && argv[i][6] != '=')) {
+                fprintf(stderr, "Unknown option: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        } else {
+            word_len = atoi(argv[i]);
+        }
+    }
+    if (!engine_len_supported(word_len)) {
+        fprintf(stderr, "Word length must be %d..%d.\n", ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN);
+        return 1;
+    }
 
     // Signals
     struct sigaction sa;
@@ -902,13 +2080,62 @@ int main(int argc, char **argv) {
     // Create shared memory (fresh run: remove if leftover)
     shm_unlink(SHM_NAME);
     shm_init_or_attach(true);
+    g_sh->word_len = word_len;
+    g_sh->auto_word = auto_word;
+    g_sh->word_rules = word_rules;
+    g_sh->grace_ms = (grace_s > 0 ? grace_s : 0) * 1000;
+    engine_new_game(&g_sh->game, NULL, word_len);
+    g_auto.rng = seed ^ 0x9E3779B97F4A7C15ull;
+    if (!g_auto.rng) g_auto.rng = 1;             // xorshift state must be nonzero
+
+    if (record_path) {
+        g_rec_fd = open(record_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        rec_header_t h = { REC_MAGIC, (uint32_t)word_len, seed, (uint64_t)time(NULL) };
+        if (g_rec_fd < 0 || write(g_rec_fd, &h, sizeof(h)) != (ssize_t)sizeof(h)) {
+            perror("record");
+            shm_unlink(SHM_NAME);
+            return 1;
+        }
+        g_rec_start_ms = mono_ms();
+    }
 
-    // Load persistent scores
-    scores_load("scores.txt");
+    // Listen before touching the score store so clients can connect at once
+    g_listen_fd = make_listen_socket(port);
     log_enqueuef("Server starting on port %u.", (unsigned)port);
 
+    // scores.idx is only mapped here (no parsing); scores.txt loads in the background
+    if (score_index_open(&g_score_idx, SCORES_IDX) != 0) {
+        fprintf(stderr, "Ignoring unreadable %s.\n", SCORES_IDX);
+    }
+    if (dict_open(&g_dict, DICT_PATH) == 0) {
+        log_enqueuef("Dictionary %s: %llu words of length %d.", DICT_PATH,
+                     (unsigned long long)dict_count(&g_dict, word_len), word_len);
+    } else {
+        log_enqueuef("No usable %s; accepting any %d-letter A-Z word.", DICT_PATH, word_len);
+    }
+    if (auto_word) {
+        if (rank_open(&g_rank, RANK_PATH) != 0) memset(&g_rank, 0, sizeof(g_rank));
+        if (auto_pool_build(word_len) != 0) {
+            fprintf(stderr, "--auto needs %s with at least %d %d-letter words (see dictbuild).\n", DICT_PATH, AUTO_BUCKETS, word_len);
+            shm_unlink(SHM_NAME);
+            return 1;
+        }
+        log_enqueuef("Auto wordmaster: %zu words in %d buckets of ~%zu, drawing from %s.", g_auto.n,
+                     AUTO_BUCKETS, g_auto.n / AUTO_BUCKETS,
+                     g_auto.bucket < 0 ? "any bucket" : g_auto_bucket_names[g_auto.bucket]);
+        if (g_auto.bucket_guesses[AUTO_BUCKETS - 1] > 0) {
+            log_enqueuef("Buckets ranked by %s (%u bot games per word): easy <= %.1f, medium <= %.1f, "
+                         "hard <= %.1f mean guesses.", RANK_PATH, g_rank.hdr->seeds,
+                         (double)g_auto.bucket_guesses[0], (double)g_auto.bucket_guesses[1],
+                         (double)g_auto.bucket_guesses[2]);
+        } else {
+            log_enqueuef("Buckets ranked by letter frequency (%s has no %d-letter words).", RANK_PATH, word_len);
+        }
+    }
+    stats_load(STATS_PATH);
+
     // Start threads (parent only)
-    pthread_t logger_th, sched_th;
+    pthread_t logger_th, sched_th, loader_th;
     if (pthread_create(&logger_th, NULL, logger_thread_main, NULL) != 0) {
         perror("pthread_create(logger)");
         return 1;
@@ -917,13 +2144,15 @@ int main(int argc, char **argv) {
         perror("pthread_create(scheduler)");
         return 1;
     }
+    if (pthread_create(&loader_th, NULL, score_loader_thread_main, NULL) != 0) {
+        perror("pthread_create(score loader)");
+        return 1;
+    }
 
-    // Create listening socket
-    g_listen_fd = make_listen_socket(port);
-
-    // Accept exactly 3 players; assign by connection order
-    int next_player_id = 0;
-    while (!g_sigint && next_player_id < MAX_PLAYERS) {
+    // Accept until SIGINT: each child claims a slot at NAME (in connection
+    // order, guessers only with --auto) or takes one back with RESUME; the
+    // rest are told the room is full
+    while (!g_sigint) {
         struct sockaddr_in cli;
         socklen_t clen = sizeof(cli);
         int cfd = accept(g_listen_fd, (struct sockaddr*)&cli, &clen);
@@ -943,18 +2172,14 @@ int main(int argc, char **argv) {
             // child
             close(g_listen_fd);
             // Child attaches to shared memory (already mapped by fork, so g_sh is valid)
-            child_session(cfd, next_player_id);
+            child_session(cfd);
             _exit(0);
         } else {
             // parent
             close(cfd);
-            log_enqueuef("Forked child %d for player slot %d.", pid, next_player_id);
-            next_player_id++;
+            log_enqueuef("Forked child %d for a new connection.", pid);
         }
     }
-
-    // Parent: keep running to allow multiple games until SIGINT
-    // In this skeleton we keep the accept loop closed after 3 players; you could extend to reconnect logic later.
     while (!g_sigint) {
         usleep(50 * 1000);
     }
@@ -963,8 +2188,11 @@ int main(int argc, char **argv) {
     log_enqueuef("Server shutting down (SIGINT). Saving scores and cleaning up.");
     g_sh->shutting_down = 1;
 
-    // Save scores
-    scores_save("scores.txt");
+    // Save scores (and fold them into the index) and any stats not yet flushed
+    pthread_join(loader_th, NULL);
+    scores_save(SCORES_TXT);
+    scores_compact();
+    stats_save(STATS_PATH);
 
     // Join threads
     pthread_join(sched_th, NULL);
@@ -972,6 +2200,11 @@ int main(int argc, char **argv) {
 
     if (g_listen_fd >= 0) close(g_listen_fd);
 
+    score_index_close(&g_score_idx);
+    dict_close(&g_dict);
+    rank_close(&g_rank);
+    free(g_auto.words);
+    if (g_rec_fd >= 0) close(g_rec_fd);
     munmap(g_sh, sizeof(shared_t));
     shm_unlink(SHM_NAME);
 
@@ -0,0 +1,220 @@
+// sim.c - Headless game simulator: engine + bots, no sockets, no shm
+// Build: make sim   (gcc ... sim.c bot.o engine.o -o sim -lm)
+//
+// Usage:
+//   ./sim [-n games] [-l word_len] [-a strategy] [-b strategy] [-t threads] [-s seed] [-d dict.idx]
+// Strategies: info (default), freq, random - see bot.h
+// Example (what `make bench-sim` runs, needs dict.idx):
+//   ./sim -n 200000 -a info -b info
+//   ./sim -n 5000000 -a freq -b random
+//
+// Each thread plays its share of the games back to back: a secret drawn
+// from the dictionary, then guesser A (always first to move) and guesser B
+// alternate through engine_apply_guess() exactly as the server does, both
+// bots seeing every move. Thread t is seeded with seed + t, so a run is
+// repeatable for a given -n/-t/-s. Per-thread tallies are merged at the end:
+//   - games/sec and guesses/sec (rule balancing and perf regressions)
+//   - A/B/draw split, solve rate, passes and per-player score histograms
+//   - first-move win rate by the result of A's opening guess
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bot.h"
+#include "engine.h"
+
+#define MAX_THREADS 64
+#define MAX_SCORE (ENGINE_MAX_WORD_LEN * ENGINE_MAX_PASSES)   // one player, every guess correct
+
+typedef struct {
+    uint64_t games;
+    uint64_t guesses;
+    uint64_t solved;
+    uint64_t wins[3];                       // [0] draw, [1] A, [2] B
+    uint64_t passes[ENGINE_MAX_PASSES + 1];
+    uint64_t score[3][MAX_SCORE + 1];       // [1] A, [2] B
+    uint64_t first[3][3];                   // [opening result][winner]
+} sim_tally_t;
+
+typedef struct {
+    const dict_t *dict;
+    int len;
+    bot_strategy_t strat[3];
+    uint64_t seed;
+    uint64_t games;
+    int failed;
+    sim_tally_t t;
+} sim_worker_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void *worker_main(void *arg) {
+    sim_worker_t *w = (sim_worker_t*)arg;
+    bot_t bots[3];
+    for (int p = 1; p <= 2; p++) {
+        if (bot_init(&bots[p], w->dict, w->len, w->seed * 2 + (uint64_t)p) != 0) {
+            if (p == 2) bot_free(&bots[1]);
+            w->failed = 1;
+            return NULL;
+        }
+        bots[p].strategy = w->strat[p];
+    }
+
+    engine_game_t g;
+    engine_move_t mv;
+    char secret[ENGINE_MAX_WORD_LEN + 1];
+    sim_tally_t *t = &w->t;
+
+    for (uint64_t n = 0; n < w->games; n++) {
+        bot_random_word(&bots[1], secret);
+        engine_new_game(&g, secret, w->len);
+        bot_new_game(&bots[1]);
+        bot_new_game(&bots[2]);
+
+        int opening = -1;
+        while (!g.over) {
+            char c = bot_choose(&bots[g.turn], g.pos);
+            engine_apply_guess(&g, c, &mv);
+            bot_observe(&bots[1], mv.pos, c, mv.result);
+            bot_observe(&bots[2], mv.pos, c, mv.result);
+            if (opening < 0) opening = (int)mv.result;
+            t->guesses++;
+        }
+
+        int winner = (g.score[1] > g.score[2]) ? 1 : (g.score[2] > g.score[1]) ? 2 : 0;
+        t->games++;
+        t->solved += (g.revealed == g.len);
+        t->wins[winner]++;
+        t->passes[mv.pass + 1]++;          // pass of the final guess
+        t->score[1][g.score[1]]++;
+        t->score[2][g.score[2]]++;
+        t->first[opening][winner]++;
+    }
+
+    bot_free(&bots[1]);
+    bot_free(&bots[2]);
+    return NULL;
+}
+
+static double pct(uint64_t a, uint64_t b) {
+    return b ? 100.0 * (double)a / (double)b : 0.0;
+}
+
+static void print_scores(const char *label, const uint64_t *hist, uint64_t games) {
+    int top = 0;
+    uint64_t sum = 0;
+    for (int s = 0; s <= MAX_SCORE; s++) {
+        if (hist[s]) top = s;
+        sum += (uint64_t)s * hist[s];
+    }
+    printf("score %s: mean %.2f |", label, games ? (double)sum / (double)games : 0.0);
+    for (int s = 0; s <= top; s++) printf(" %d:%.1f%%", s, pct(hist[s], games));
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    uint64_t games = 1000000;
+    int len = ENGINE_WORD_LEN;
+    int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = 1;
+    const char *dict_path = "dict.idx";
+    bot_strategy_t strat[3] = { BOT_INFO, BOT_INFO, BOT_INFO };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:a:b:t:s:d:")) != -1) {
+        switch (opt) {
+        case 'n': games = strtoull(optarg, NULL, 10); break;
+        case 'l': len = atoi(optarg); break;
+        case 'a':
+        case 'b':
+            if (bot_strategy_parse(optarg, &strat[opt == 'a' ? 1 : 2]) != 0) {
+                fprintf(stderr, "Unknown strategy: %s (info, freq, random)\n", optarg);
+                return 1;
+            }
+            break;
+        case 't': nthreads = atoi(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'd': dict_path = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n games] [-l word_len] [-a strategy] [-b strategy] "
+                            "[-t threads] [-s seed] [-d dict.idx]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    if (!engine_len_supported(len)) {
+        fprintf(stderr, "Word length must be %d..%d.\n", ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN);
+        return 1;
+    }
+
+    dict_t dict;
+    if (dict_open(&dict, dict_path) != 0 || dict_count(&dict, len) == 0) {
+        fprintf(stderr, "Need %s with %d-letter words (build it with dictbuild).\n", dict_path, len);
+        return 1;
+    }
+
+    static sim_worker_t w[MAX_THREADS];
+    pthread_t th[MAX_THREADS];
+    double t0 = now_sec();
+    for (int t = 0; t < nthreads; t++) {
+        w[t].dict = &dict;
+        w[t].len = len;
+        memcpy(w[t].strat, strat, sizeof(strat));
+        w[t].seed = seed + (uint64_t)t;
+        w[t].games = games * (uint64_t)(t + 1) / (uint64_t)nthreads - games * (uint64_t)t / (uint64_t)nthreads;
+        pthread_create(&th[t], NULL, worker_main, &w[t]);
+    }
+
+    sim_tally_t all;
+    memset(&all, 0, sizeof(all));
+    for (int t = 0; t < nthreads; t++) {
+        pthread_join(th[t], NULL);
+        if (w[t].failed) {
+            fprintf(stderr, "Thread %d could not set up its bots.\n", t);
+            return 1;
+        }
+        const uint64_t *src = (const uint64_t*)&w[t].t;
+        uint64_t *dst = (uint64_t*)&all;
+        for (size_t i = 0; i < sizeof(all) / sizeof(uint64_t); i++) dst[i] += src[i];
+    }
+    double secs = now_sec() - t0;
+    unsigned long long dict_words = (unsigned long long)dict_count(&dict, len);
+    dict_close(&dict);
+
+    printf("A=%s B=%s len=%d threads=%d seed=%llu dict=%llu words\n",
+           bot_strategy_name(strat[1]), bot_strategy_name(strat[2]), len, nthreads,
+           (unsigned long long)seed, dict_words);
+    printf("games=%llu in %.3f s: %.0f games/s, %.0f guesses/s, %.2f guesses/game\n",
+           (unsigned long long)all.games, secs,
+           secs > 0 ? (double)all.games / secs : 0.0,
+           secs > 0 ? (double)all.guesses / secs : 0.0,
+           all.games ? (double)all.guesses / (double)all.games : 0.0);
+    printf("winA=%.1f%% winB=%.1f%% draw=%.1f%% solved=%.1f%%\n",
+           pct(all.wins[1], all.games), pct(all.wins[2], all.games),
+           pct(all.wins[0], all.games), pct(all.solved, all.games));
+    printf("passes:");
+    for (int p = 1; p <= ENGINE_MAX_PASSES; p++) printf(" %d:%.1f%%", p, pct(all.passes[p], all.games));
+    printf("\n");
+    print_scores("A", all.score[1], all.games);
+    print_scores("B", all.score[2], all.games);
+
+    static const char *names[] = { "ABSENT", "PRESENT", "CORRECT" };
+    for (int r = 0; r < 3; r++) {
+        uint64_t n = all.first[r][0] + all.first[r][1] + all.first[r][2];
+        printf("first=%-7s games=%.1f%% winA=%.1f%% winB=%.1f%% draw=%.1f%%\n",
+               names[r], pct(n, all.games), pct(all.first[r][1], n),
+               pct(all.first[r][2], n), pct(all.first[r][0], n));
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// trace.h - Client traffic trace format (client --record=FILE, --replay=FILE)
+//
+// One header, then one variable-length record per protocol line the client
+// sent or received, in the order it saw them:
+//
+//   varint  (dt_us << 1) | dir     dt_us: CLOCK_MONOTONIC microseconds since
+//                                  the previous record (the first: since the
+//                                  recording started); dir: TRACE_RECV/SENT
+//   varint  len                    line length, without the newline
+//   len bytes                      the line
+//
+// Varints are LEB128 (7 bits per byte, low group first), so a typical
+// record is the line plus 3-4 bytes. Unlike rec.h this is the wire as one
+// player saw it, including timing, so replays can re-drive a live server.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_MAGIC 0x31435254u     // "TRC1"
+#define TRACE_MAX_LINE 512
+
+enum {
+    TRACE_RECV = 0,
+    TRACE_SENT = 1
+};
+
+typedef struct {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t start_time;            // unix seconds when recording started
+} trace_header_t;
+
+_Static_assert(sizeof(trace_header_t) == 16, "trace_header_t layout changed");
+
+static inline size_t trace_put_varint(uint8_t *out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline const uint8_t *trace_get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v) {
+    *v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        *v |= (uint64_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) return p;
+    }
+    return NULL;
+}
+
+// out: at least TRACE_MAX_LINE + 20 bytes; len is clamped to TRACE_MAX_LINE.
+// Returns the record's size.
+static inline size_t trace_encode(uint8_t *out, uint64_t dt_us, int dir, const char *line, size_t len) {
+    if (len > TRACE_MAX_LINE) len = TRACE_MAX_LINE;
+    size_t n = trace_put_varint(out, (dt_us << 1) | (uint64_t)(dir & 1));
+    n += trace_put_varint(out + n, len);
+    for (size_t i = 0; i < len; i++) out[n + i] = (uint8_t)line[i];
+    return n + len;
+}
+
+// Decodes the record at p; returns the next record, or NULL at the end of
+// the data or on a truncated record. *line points into the buffer.
+static inline const uint8_t *trace_decode(const uint8_t *p, const uint8_t *end, uint64_t *dt_us,
+                                          int *dir, const char **line, size_t *len) {
+    uint64_t head, n;
+    if (p >= end || !(p = trace_get_varint(p, end, &head)) || !(p = trace_get_varint(p, end, &n))) return NULL;
+    if (n > TRACE_MAX_LINE || n > (uint64_t)(end - p)) return NULL;
+    *dt_us = head >> 1;
+    *dir = (int)(head & 1);
+    *line = (const char*)p;
+    *len = (size_t)n;
+    return p + n;
+}
+
+#endif
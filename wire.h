@@ -0,0 +1,331 @@
+// wire.h - Binary framing for the game protocol, negotiated per connection
+//
+// Text lines stay the default. The server advertises this framing on its
+// WELCOME line (WIRE_HELLO); a client that wants it appends WIRE_HELLO to
+// its NAME (or RESUME) line, and every byte the server sends after that
+// line is a frame:
+//
+//   uint8   len                    bytes that follow (type + payload)
+//   uint8   type                   WIRE_*
+//   payload                        fixed layout per type; WIRE_TEXT: the line
+//
+// STATE, YOUR_TURN, GAME_OVER and ROLE have fixed layouts (a letter-rule
+// STATE frame is 16 bytes, ~130 as text); the rare lines (INFO, ERR, OK,
+// ENTER_WORD, SESSION, RESUMED) travel as WIRE_TEXT. Client input stays
+// text: one short line per turn.
+//
+// A word or display packs into a little-endian uint64: the length in the
+// low 4 bits, then 5 bits per position (0 = '_', 1..26 = 'A'..'Z').
+// Feedback packs 2 bits per position (engine_result_t) into 3 bytes.
+//
+// wire_text_*() render the text line for the same message, byte for byte
+// what a text client receives, so the server formats both encodings from
+// one struct and wire_bench checks that they agree.
+
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "engine.h"
+
+#define WIRE_HELLO " proto=bin1"
+#define WIRE_MAX_FRAME 256             // len byte + up to 255 more
+#define WIRE_MAX_LEN ENGINE_MAX_WORD_LEN
+
+enum {
+    WIRE_TEXT       = 1,
+    WIRE_ROLE       = 2,
+    WIRE_YOUR_TURN  = 3,
+    WIRE_STATE      = 4,               // letter rules
+    WIRE_STATE_WORD = 5,               // --rules=word
+    WIRE_GAME_OVER  = 6
+};
+
+typedef struct {
+    int player;                        // 0 wordmaster, 1/2 guesser
+    int len;
+    int word_rules;
+} wire_role_t;
+
+typedef struct {
+    int pass;                          // 1-based
+    int pos;                           // 1-based
+    int word_rules;
+    char display[WIRE_MAX_LEN + 1];
+} wire_turn_t;
+
+typedef struct {
+    int word_rules;                    // 1: guessword/feedback; 0: pos/letter/result
+    int from;                          // guesser that moved
+    int turn;                          // guesser to move, 0 once over
+    int pass, next_pass;               // 1-based
+    int pos, next_pos;                 // 1-based (letter rules)
+    char letter;                       // letter rules
+    int result;                        // engine_result_t (letter rules)
+    int score_a, score_b;
+    char guessword[WIRE_MAX_LEN + 1];  // word rules
+    char feedback[WIRE_MAX_LEN + 1];   // word rules: 'C', 'P', 'A' per position
+    char display[WIRE_MAX_LEN + 1];
+} wire_state_t;
+
+typedef struct {
+    char word[WIRE_MAX_LEN + 1];
+    char display[WIRE_MAX_LEN + 1];
+    int passes;
+    int score_a, score_b;
+    int winner;                        // 0 draw, 1/2
+} wire_over_t;
+
+// ---------- Packing ----------
+
+static inline void wire_put_u64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static inline uint64_t wire_get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+static inline uint64_t wire_pack_word(const char *w) {
+    uint64_t v = 0;
+    int n = 0;
+    for (; n < WIRE_MAX_LEN && w[n]; n++) {
+        unsigned c = (w[n] >= 'A' && w[n] <= 'Z') ? (unsigned)(w[n] - 'A' + 1) : 0;
+        v |= (uint64_t)c << (4 + 5 * n);
+    }
+    return v | (uint64_t)n;
+}
+
+// out: WIRE_MAX_LEN + 1 bytes
+static inline void wire_unpack_word(uint64_t v, char *out) {
+    int n = (int)(v & 15);
+    if (n > WIRE_MAX_LEN) n = WIRE_MAX_LEN;
+    for (int i = 0; i < n; i++) {
+        unsigned c = (unsigned)(v >> (4 + 5 * i)) & 31;
+        out[i] = (c >= 1 && c <= 26) ? (char)('A' + c - 1) : '_';
+    }
+    out[n] = '\0';
+}
+
+static inline const char *wire_result_name(int r) {
+    return r == ENGINE_CORRECT ? "CORRECT" : r == ENGINE_PRESENT ? "PRESENT" : "ABSENT";
+}
+
+// Starts a frame; returns the payload pointer
+static inline uint8_t *wire_begin(uint8_t *out, int type) {
+    out[1] = (uint8_t)type;
+    return out + 2;
+}
+
+// Closes a frame whose payload ends at end; returns the frame size
+static inline size_t wire_end(uint8_t *out, const uint8_t *end) {
+    size_t n = (size_t)(end - out);
+    out[0] = (uint8_t)(n - 1);
+    return n;
+}
+
+// ---------- Encoders (out: WIRE_MAX_FRAME bytes; return the frame size) ----------
+
+static inline size_t wire_put_text(uint8_t *out, const char *line) {
+    size_t n = strlen(line);
+    if (n > 254) n = 254;
+    uint8_t *p = wire_begin(out, WIRE_TEXT);
+    memcpy(p, line, n);
+    return wire_end(out, p + n);
+}
+
+static inline size_t wire_put_role(uint8_t *out, const wire_role_t *r) {
+    uint8_t *p = wire_begin(out, WIRE_ROLE);
+    *p++ = (uint8_t)r->player;
+    *p++ = (uint8_t)r->len;
+    *p++ = (uint8_t)r->word_rules;
+    return wire_end(out, p);
+}
+
+static inline size_t wire_put_turn(uint8_t *out, const wire_turn_t *t) {
+    uint8_t *p = wire_begin(out, WIRE_YOUR_TURN);
+    *p++ = (uint8_t)t->pass;
+    *p++ = (uint8_t)(t->pos | (t->word_rules ? 0x80 : 0));
+    wire_put_u64(p, wire_pack_word(t->display));
+    return wire_end(out, p + 8);
+}
+
+// Pass, position and player numbers fit a nibble each
+static inline size_t wire_put_state(uint8_t *out, const wire_state_t *s) {
+    uint8_t *p = wire_begin(out, s->word_rules ? WIRE_STATE_WORD : WIRE_STATE);
+    *p++ = (uint8_t)(s->from << 4 | s->turn);
+    *p++ = (uint8_t)(s->pass << 4 | s->next_pass);
+    if (s->word_rules) {
+        *p++ = (uint8_t)s->score_a;
+        *p++ = (uint8_t)s->score_b;
+        wire_put_u64(p, wire_pack_word(s->guessword));
+        p += 8;
+        uint32_t fb = 0;
+        for (int i = 0; i < WIRE_MAX_LEN && s->feedback[i]; i++) {
+            uint32_t r = s->feedback[i] == 'C' ? ENGINE_CORRECT : s->feedback[i] == 'P' ? ENGINE_PRESENT : ENGINE_ABSENT;
+            fb |= r << (2 * i);
+        }
+        *p++ = (uint8_t)fb;
+        *p++ = (uint8_t)(fb >> 8);
+        *p++ = (uint8_t)(fb >> 16);
+    } else {
+        *p++ = (uint8_t)(s->pos << 4 | s->next_pos);
+        *p++ = (uint8_t)((s->letter >= 'A' && s->letter <= 'Z' ? s->letter - 'A' : 31) | s->result << 5);
+        *p++ = (uint8_t)s->score_a;
+        *p++ = (uint8_t)s->score_b;
+    }
+    wire_put_u64(p, wire_pack_word(s->display));
+    return wire_end(out, p + 8);
+}
+
+static inline size_t wire_put_over(uint8_t *out, const wire_over_t *o) {
+    uint8_t *p = wire_begin(out, WIRE_GAME_OVER);
+    wire_put_u64(p, wire_pack_word(o->word));
+    wire_put_u64(p + 8, wire_pack_word(o->display));
+    p += 16;
+    *p++ = (uint8_t)o->passes;
+    *p++ = (uint8_t)o->score_a;
+    *p++ = (uint8_t)o->score_b;
+    *p++ = (uint8_t)o->winner;
+    return wire_end(out, p);
+}
+
+// ---------- Decoders (payload after the type byte; 0, or -1 if too short) ----------
+
+static inline int wire_get_role(const uint8_t *p, size_t n, wire_role_t *r) {
+    if (n < 3) return -1;
+    r->player = p[0];
+    r->len = p[1];
+    r->word_rules = p[2];
+    return 0;
+}
+
+static inline int wire_get_turn(const uint8_t *p, size_t n, wire_turn_t *t) {
+    if (n < 10) return -1;
+    t->pass = p[0];
+    t->pos = p[1] & 0x7f;
+    t->word_rules = p[1] >> 7;
+    wire_unpack_word(wire_get_u64(p + 2), t->display);
+    return 0;
+}
+
+static inline int wire_get_state(int type, const uint8_t *p, size_t n, wire_state_t *s) {
+    s->word_rules = (type == WIRE_STATE_WORD);
+    if (n < (s->word_rules ? 23u : 14u)) return -1;
+    s->from = p[0] >> 4;
+    s->turn = p[0] & 15;
+    s->pass = p[1] >> 4;
+    s->next_pass = p[1] & 15;
+    if (s->word_rules) {
+        s->score_a = p[2];
+        s->score_b = p[3];
+        wire_unpack_word(wire_get_u64(p + 4), s->guessword);
+        uint32_t fb = (uint32_t)p[12] | (uint32_t)p[13] << 8 | (uint32_t)p[14] << 16;
+        int len = (int)strlen(s->guessword);
+        for (int i = 0; i < len; i++) s->feedback[i] = "APC?"[(fb >> (2 * i)) & 3];
+        s->feedback[len] = '\0';
+        s->pos = s->next_pos = 0;
+        s->letter = '\0';
+        s->result = 0;
+        p += 15;
+    } else {
+        s->pos = p[2] >> 4;
+        s->next_pos = p[2] & 15;
+        s->letter = (p[3] & 31) < 26 ? (char)('A' + (p[3] & 31)) : '?';
+        s->result = p[3] >> 5;
+        s->score_a = p[4];
+        s->score_b = p[5];
+        s->guessword[0] = s->feedback[0] = '\0';
+        p += 6;
+    }
+    wire_unpack_word(wire_get_u64(p), s->display);
+    return 0;
+}
+
+static inline int wire_get_over(const uint8_t *p, size_t n, wire_over_t *o) {
+    if (n < 20) return -1;
+    wire_unpack_word(wire_get_u64(p), o->word);
+    wire_unpack_word(wire_get_u64(p + 8), o->display);
+    o->passes = p[16];
+    o->score_a = p[17];
+    o->score_b = p[18];
+    o->winner = p[19];
+    return 0;
+}
+
+// ---------- Text rendering (the text protocol's lines) ----------
+
+static inline void wire_text_role(char *out, size_t cap, const wire_role_t *r) {
+    if (r->player == 0) snprintf(out, cap, "ROLE WORDMASTER len=%d", r->len);
+    else snprintf(out, cap, "ROLE GUESSER %d len=%d%s", r->player, r->len, r->word_rules ? " rules=word" : "");
+}
+
+static inline void wire_text_turn(char *out, size_t cap, const wire_turn_t *t) {
+    if (t->word_rules) {
+        snprintf(out, cap, "YOUR_TURN pass=%d/%d pos=%d display=%s (send: GUESSWORD %.*s)",
+                 t->pass, ENGINE_MAX_PASSES, t->pos, t->display, (int)strlen(t->display), "ABCDEFGHIJKL");
+    } else {
+        snprintf(out, cap, "YOUR_TURN pass=%d/%d pos=%d display=%s (send: GUESS X)",
+                 t->pass, ENGINE_MAX_PASSES, t->pos, t->display);
+    }
+}
+
+static inline void wire_text_state(char *out, size_t cap, const wire_state_t *s) {
+    if (s->word_rules) {
+        snprintf(out, cap,
+                 "STATE from=%d pass=%d/%d guessword=%s feedback=%s display=%s scoreA=%d scoreB=%d next_pass=%d/%d turn=%d",
+                 s->from, s->pass, ENGINE_MAX_PASSES, s->guessword, s->feedback, s->display,
+                 s->score_a, s->score_b, s->next_pass, ENGINE_MAX_PASSES, s->turn);
+    } else {
+        snprintf(out, cap,
+                 "STATE from=%d pass=%d/%d pos=%d guess=%c result=%s display=%s scoreA=%d scoreB=%d next_pass=%d/%d next_pos=%d turn=%d",
+                 s->from, s->pass, ENGINE_MAX_PASSES, s->pos, s->letter, wire_result_name(s->result), s->display,
+                 s->score_a, s->score_b, s->next_pass, ENGINE_MAX_PASSES, s->next_pos, s->turn);
+    }
+}
+
+static inline void wire_text_over(char *out, size_t cap, const wire_over_t *o) {
+    snprintf(out, cap, "GAME_OVER word=%s display=%s passes=%d scoreA=%d scoreB=%d winner=%s",
+             o->word, o->display, o->passes, o->score_a, o->score_b,
+             o->winner == 1 ? "PLAYER1" : o->winner == 2 ? "PLAYER2" : "DRAW");
+}
+
+// Any frame as its text line (a WIRE_TEXT payload is copied); -1 if the
+// type is unknown or the payload short
+static inline int wire_text(char *out, size_t cap, int type, const uint8_t *p, size_t n) {
+    wire_role_t r;
+    wire_turn_t t;
+    wire_state_t s;
+    wire_over_t o;
+    switch (type) {
+    case WIRE_TEXT:
+        snprintf(out, cap, "%.*s", (int)n, (const char*)p);
+        return 0;
+    case WIRE_ROLE:
+        if (wire_get_role(p, n, &r) != 0) return -1;
+        wire_text_role(out, cap, &r);
+        return 0;
+    case WIRE_YOUR_TURN:
+        if (wire_get_turn(p, n, &t) != 0) return -1;
+        wire_text_turn(out, cap, &t);
+        return 0;
+    case WIRE_STATE:
+    case WIRE_STATE_WORD:
+        if (wire_get_state(type, p, n, &s) != 0) return -1;
+        wire_text_state(out, cap, &s);
+        return 0;
+    case WIRE_GAME_OVER:
+        if (wire_get_over(p, n, &o) != 0) return -1;
+        wire_text_over(out, cap, &o);
+        return 0;
+    }
+    return -1;
+}
+
+#endif
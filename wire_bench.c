@@ -0,0 +1,278 @@
+// wire_bench.c - wire.h frames against the text lines they replace
+// Build: make wire_bench   (gcc -O2 -Wall -Wextra -pedantic wire_bench.c engine.c -o wire_bench)
+//
+// Usage:
+//   ./wire_bench [-n games] [-r rounds] [-l word_len] [-s seed] [-w]
+//     -n   games played to build the message corpus (default 20000)
+//     -r   timed passes over the corpus (default 10)
+//     -w   GUESSWORD rules (random whole-word guesses) instead of letters
+//
+// The corpus is what a room's server sends during real engine games: ROLE
+// to each seat, YOUR_TURN to the guesser to move, STATE and GAME_OVER to
+// all three seats, built from the engine's moves the way server.c does.
+//
+// Check: every frame, rendered back with wire_text(), must equal the text
+// line server.c formats for the same message; any difference exits 2.
+//
+// Bytes: per game, as received by the three seats (text lines counted with
+// their newline). Timing: per game, the text path (snprintf() on the
+// server, proto_parse() of every field the client reads) against the frame
+// path (wire_put_*() and wire_get_*()).
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engine.h"
+#include "proto.h"
+#include "wire.h"
+
+typedef struct {
+    int type;                           // WIRE_*
+    int fanout;                         // seats that receive it
+    union {
+        wire_role_t role;
+        wire_turn_t turn;
+        wire_state_t state;
+        wire_over_t over;
+    } u;
+} msg_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint32_t xorshift32(uint32_t *s) {
+    uint32_t x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+// ---------- Corpus ----------
+
+static msg_t *push(msg_t **v, size_t *n, size_t *cap, int type, int fanout) {
+    if (*n == *cap) {
+        *cap = *cap ? *cap * 2 : 4096;
+        msg_t *grown = realloc(*v, *cap * sizeof(msg_t));
+        if (!grown) { perror("realloc"); exit(1); }
+        *v = grown;
+    }
+    msg_t *m = &(*v)[(*n)++];
+    memset(m, 0, sizeof(*m));
+    m->type = type;
+    m->fanout = fanout;
+    return m;
+}
+
+static void random_word(uint32_t *rng, char *w, int len) {
+    for (int i = 0; i < len; i++) w[i] = (char)('A' + xorshift32(rng) % 26);
+    w[len] = '\0';
+}
+
+static msg_t *play_games(long games, int len, int word_rules, uint32_t seed, size_t *n_out) {
+    msg_t *v = NULL;
+    size_t n = 0, cap = 0;
+    uint32_t rng = seed ? seed : 1;
+    for (long gi = 0; gi < games; gi++) {
+        char secret[ENGINE_MAX_WORD_LEN + 1];
+        random_word(&rng, secret, len);
+        engine_game_t g;
+        engine_new_game(&g, secret, len);
+        for (int p = 0; p <= 2; p++) {
+            msg_t *m = push(&v, &n, &cap, WIRE_ROLE, 1);
+            m->u.role = (wire_role_t){ .player = p, .len = len, .word_rules = word_rules };
+        }
+
+        while (!g.over) {
+            engine_snapshot_t snap;
+            engine_snapshot(&g, &snap);
+            msg_t *m = push(&v, &n, &cap, WIRE_YOUR_TURN, 1);
+            m->u.turn.pass = snap.pass + 1;
+            m->u.turn.pos = snap.pos + 1;
+            m->u.turn.word_rules = word_rules;
+            memcpy(m->u.turn.display, snap.display, sizeof(m->u.turn.display));
+
+            int from = g.turn, pass_before, pos_before = 0, result = 0;
+            char letter = '\0', guess[ENGINE_MAX_WORD_LEN + 1] = "", feedback[ENGINE_MAX_WORD_LEN + 1] = "";
+            if (word_rules) {
+                engine_word_move_t wm;
+                random_word(&rng, guess, len);
+                engine_apply_word(&g, guess, &wm);
+                for (int i = 0; i < len; i++) feedback[i] = "APC"[ENGINE_FEEDBACK_AT(wm.feedback, i)];
+                feedback[len] = '\0';
+                pass_before = wm.pass;
+            } else {
+                engine_move_t mv;
+                letter = (char)('A' + xorshift32(&rng) % 26);
+                engine_apply_guess(&g, letter, &mv);
+                pass_before = mv.pass;
+                pos_before = mv.pos;
+                result = (int)mv.result;
+            }
+
+            engine_snapshot(&g, &snap);
+            m = push(&v, &n, &cap, WIRE_STATE, 3);
+            wire_state_t *st = &m->u.state;
+            *st = (wire_state_t){
+                .word_rules = word_rules, .from = from, .turn = snap.turn,
+                .pass = pass_before + 1, .next_pass = snap.pass + 1,
+                .pos = pos_before + 1, .next_pos = snap.pos + 1, .letter = letter, .result = result,
+                .score_a = snap.score_a, .score_b = snap.score_b,
+            };
+            if (word_rules) {
+                memcpy(st->guessword, guess, sizeof(st->guessword));
+                memcpy(st->feedback, feedback, sizeof(st->feedback));
+            }
+            memcpy(st->display, snap.display, sizeof(st->display));
+
+            if (g.over) {
+                m = push(&v, &n, &cap, WIRE_GAME_OVER, 3);
+                wire_over_t *o = &m->u.over;
+                o->passes = snap.pass;
+                o->score_a = snap.score_a;
+                o->score_b = snap.score_b;
+                o->winner = snap.score_a > snap.score_b ? 1 : snap.score_b > snap.score_a ? 2 : 0;
+                memcpy(o->word, secret, sizeof(o->word));
+                memcpy(o->display, snap.display, sizeof(o->display));
+            }
+        }
+    }
+    *n_out = n;
+    return v;
+}
+
+// ---------- Encodings ----------
+
+static void text_line(const msg_t *m, char *out, size_t cap) {
+    switch (m->type) {
+    case WIRE_ROLE:      wire_text_role(out, cap, &m->u.role); break;
+    case WIRE_YOUR_TURN: wire_text_turn(out, cap, &m->u.turn); break;
+    case WIRE_STATE:     wire_text_state(out, cap, &m->u.state); break;
+    default:             wire_text_over(out, cap, &m->u.over); break;
+    }
+}
+
+static size_t frame(const msg_t *m, uint8_t *out) {
+    switch (m->type) {
+    case WIRE_ROLE:      return wire_put_role(out, &m->u.role);
+    case WIRE_YOUR_TURN: return wire_put_turn(out, &m->u.turn);
+    case WIRE_STATE:     return wire_put_state(out, &m->u.state);
+    default:             return wire_put_over(out, &m->u.over);
+    }
+}
+
+// What the client reads from each message, the text way
+static unsigned text_roundtrip(const msg_t *m) {
+    char line[256];
+    text_line(m, line, sizeof(line));
+    proto_line_t f;
+    proto_parse(line, &f);
+    unsigned acc = 0;
+    for (int k = 0; k < PROTO_NFIELDS; k++) {
+        if (proto_has(&f, k)) acc += (unsigned)f.f[k].num + (unsigned char)f.f[k].p[0];
+    }
+    return acc;
+}
+
+// ... and the frame way
+static unsigned frame_roundtrip(const msg_t *m) {
+    uint8_t out[WIRE_MAX_FRAME];
+    size_t n = frame(m, out);
+    const uint8_t *p = out + 2;
+    size_t pn = n - 2;
+    wire_role_t r;
+    wire_turn_t t;
+    wire_state_t s;
+    wire_over_t o;
+    switch (out[1]) {
+    case WIRE_ROLE:
+        if (wire_get_role(p, pn, &r) != 0) return 0;
+        return (unsigned)(r.player + r.len + r.word_rules);
+    case WIRE_YOUR_TURN:
+        if (wire_get_turn(p, pn, &t) != 0) return 0;
+        return (unsigned)(t.pass + t.pos) + (unsigned char)t.display[0];
+    case WIRE_STATE:
+    case WIRE_STATE_WORD:
+        if (wire_get_state(out[1], p, pn, &s) != 0) return 0;
+        return (unsigned)(s.from + s.turn + s.pass + s.next_pass + s.pos + s.next_pos + s.result +
+                          s.score_a + s.score_b) + (unsigned char)s.letter + (unsigned char)s.display[0];
+    default:
+        if (wire_get_over(p, pn, &o) != 0) return 0;
+        return (unsigned)(o.passes + o.score_a + o.score_b + o.winner) + (unsigned char)o.word[0];
+    }
+}
+
+static double time_path(unsigned (*fn)(const msg_t*), const msg_t *v, size_t n, int rounds, unsigned *sink) {
+    double t0 = now_sec();
+    unsigned acc = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < n; i++) acc += fn(&v[i]);
+    }
+    *sink += acc;
+    return now_sec() - t0;
+}
+
+int main(int argc, char **argv) {
+    long games = 20000;
+    int rounds = 10, len = ENGINE_WORD_LEN, word_rules = 0;
+    uint32_t seed = 12345;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:l:s:w")) != -1) {
+        switch (opt) {
+        case 'n': games = atol(optarg); break;
+        case 'r': rounds = atoi(optarg); break;
+        case 'l': len = atoi(optarg); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+        case 'w': word_rules = 1; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n games] [-r rounds] [-l word_len] [-s seed] [-w]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (games < 1) games = 1;
+    if (rounds < 1) rounds = 1;
+    if (!engine_len_supported(len)) {
+        fprintf(stderr, "word_len must be %d..%d\n", ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN);
+        return 1;
+    }
+
+    size_t n;
+    msg_t *v = play_games(games, len, word_rules, seed, &n);
+
+    uint64_t text_bytes = 0, frame_bytes = 0;
+    long mismatches = 0;
+    for (size_t i = 0; i < n; i++) {
+        char line[256], back[WIRE_MAX_FRAME + 64];
+        uint8_t out[WIRE_MAX_FRAME];
+        text_line(&v[i], line, sizeof(line));
+        size_t flen = frame(&v[i], out);
+        text_bytes += (strlen(line) + 1) * (uint64_t)v[i].fanout;
+        frame_bytes += flen * (uint64_t)v[i].fanout;
+        if (wire_text(back, sizeof(back), out[1], out + 2, flen - 2) != 0 || strcmp(back, line) != 0) {
+            if (mismatches < 10) fprintf(stderr, "mismatch:\n  text:  %s\n  frame: %s\n", line, back);
+            mismatches++;
+        }
+    }
+    printf("check: %zu messages from %ld %s games (len %d), %ld mismatches\n",
+           n, games, word_rules ? "word-rule" : "letter-rule", len, mismatches);
+    printf("bytes/game:  text %7.1f   frames %7.1f  (%.2fx smaller)\n",
+           (double)text_bytes / (double)games, (double)frame_bytes / (double)games,
+           frame_bytes ? (double)text_bytes / (double)frame_bytes : 0.0);
+
+    unsigned sink = 0;
+    time_path(text_roundtrip, v, n, 1, &sink);      // warm caches
+    double tt = time_path(text_roundtrip, v, n, rounds, &sink);
+    double tf = time_path(frame_roundtrip, v, n, rounds, &sink);
+    double per = (double)games * rounds;
+    printf("text:   %8.1f ns/game\n", tt * 1e9 / per);
+    printf("frames: %8.1f ns/game  (%.2fx)   [sink %u]\n", tf * 1e9 / per, tf > 0 ? tt / tf : 0.0, sink);
+
+    free(v);
+    return mismatches ? 2 : 0;
+}
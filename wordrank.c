@@ -0,0 +1,268 @@
+// wordrank.c - Build rank.idx (see rank.h): bot-measured difficulty of every word
+// Build: make wordrank   (gcc ... wordrank.c bot.o engine.o -o wordrank -lm)
+//
+// Usage:
+//   ./wordrank [-l word_len] [-s seeds] [-t threads] [-d dict.idx] [-o rank.idx]
+//     -l   rank only this length (default: every length dict.idx has)
+//     -s   games per word (default 8)
+//
+// Every dictionary word is played as the secret -s times by two info bots
+// (guesser A moves first, as in the server), each game with its own bot
+// seeds. Per word it records the mean number of guesses until the game
+// ended, the solve rate, the pass the game usually ended in and A's win
+// rate, then each length's records are sorted easiest first.
+//
+// Threads pull chunks of words off a shared counter, so the build scales
+// with cores; bot seeds derive from the word and the game number only, so
+// the index is byte-identical for any -t.
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bot.h"
+#include "engine.h"
+#include "rank.h"
+
+#define MAX_THREADS 64
+#define CHUNK 64                        // words per counter bump
+
+typedef struct {
+    const dict_t *dict;
+    int len;
+    int seeds;
+    size_t nwords;
+    const uint64_t *words;              // dict_pack() keys in dictionary order
+    rank_rec_t *out;                    // [nwords], filled by index
+    size_t next;                        // next unclaimed word (atomic)
+    size_t done;                        // words finished (atomic, progress only)
+    int failed;
+} rank_job_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void rank_word(bot_t bots[3], const rank_job_t *job, uint64_t key, rank_rec_t *rec) {
+    int len = job->len;
+    char secret[ENGINE_MAX_WORD_LEN + 1];
+    uint64_t v = key - 1;
+    for (int k = 0; k < len; k++) secret[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+    secret[len] = '\0';
+
+    uint64_t guesses = 0;
+    int solved = 0, wins_a = 0;
+    int passes[ENGINE_MAX_PASSES + 1] = {0};
+    engine_game_t g;
+    engine_move_t mv;
+
+    for (int s = 0; s < job->seeds; s++) {
+        engine_new_game(&g, secret, len);
+        for (int p = 1; p <= 2; p++) {
+            bot_new_game(&bots[p]);
+            bots[p].rng = dict_mix64(key * 0x9E3779B97F4A7C15ull + (uint64_t)(2 * s + p)) | 1;
+        }
+        while (!g.over) {
+            char c = bot_choose(&bots[g.turn], g.pos);
+            engine_apply_guess(&g, c, &mv);
+            bot_observe(&bots[1], mv.pos, c, mv.result);
+            bot_observe(&bots[2], mv.pos, c, mv.result);
+            guesses++;
+        }
+        solved += (g.revealed == len);
+        wins_a += (g.score[1] > g.score[2]);
+        passes[mv.pass + 1]++;
+    }
+
+    int mode = 1;
+    for (int p = 2; p <= ENGINE_MAX_PASSES; p++) {
+        if (passes[p] > passes[mode]) mode = p;
+    }
+    rec->key = key;
+    rec->mean_guesses = (float)((double)guesses / job->seeds);
+    rec->solve_pct = (uint8_t)(100 * solved / job->seeds);
+    rec->end_pass = (uint8_t)mode;
+    rec->win_a_pct = (uint8_t)(100 * wins_a / job->seeds);
+    rec->reserved = 0;
+}
+
+static void *worker_main(void *arg) {
+    rank_job_t *job = (rank_job_t*)arg;
+    bot_t bots[3];
+    for (int p = 1; p <= 2; p++) {
+        if (bot_init(&bots[p], job->dict, job->len, 1) != 0) {
+            if (p == 2) bot_free(&bots[1]);
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+    }
+
+    for (;;) {
+        size_t lo = __atomic_fetch_add(&job->next, CHUNK, __ATOMIC_RELAXED);
+        if (lo >= job->nwords) break;
+        size_t hi = (lo + CHUNK < job->nwords) ? lo + CHUNK : job->nwords;
+        for (size_t i = lo; i < hi; i++) rank_word(bots, job, job->words[i], &job->out[i]);
+        __atomic_fetch_add(&job->done, hi - lo, __ATOMIC_RELAXED);
+    }
+
+    bot_free(&bots[1]);
+    bot_free(&bots[2]);
+    return NULL;
+}
+
+static int rank_rec_cmp(const void *a, const void *b) {
+    const rank_rec_t *x = (const rank_rec_t*)a;
+    const rank_rec_t *y = (const rank_rec_t*)b;
+    if (x->mean_guesses != y->mean_guesses) return (x->mean_guesses < y->mean_guesses) ? -1 : 1;
+    if (x->solve_pct != y->solve_pct) return (x->solve_pct > y->solve_pct) ? -1 : 1;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+// Ranks every len-letter word; returns the records (sorted) or NULL
+static rank_rec_t *rank_length(const dict_t *dict, int len, int seeds, int nthreads, size_t *n_out) {
+    rank_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.dict = dict;
+    job.len = len;
+    job.seeds = seeds;
+
+    // One bot just for the word list, so word i means the same to every worker
+    bot_t lister;
+    if (bot_init(&lister, dict, len, 1) != 0) return NULL;
+    job.nwords = lister.nwords;
+    job.words = lister.words;
+    job.out = malloc(job.nwords * sizeof(rank_rec_t));
+    if (!job.out) { bot_free(&lister); return NULL; }
+
+    double t0 = now_sec();
+    pthread_t th[MAX_THREADS];
+    for (int t = 0; t < nthreads; t++) pthread_create(&th[t], NULL, worker_main, &job);
+
+    // Progress on stderr while the workers run
+    for (;;) {
+        size_t done = __atomic_load_n(&job.done, __ATOMIC_RELAXED);
+        if (done >= job.nwords || __atomic_load_n(&job.failed, __ATOMIC_RELAXED)) break;
+        double el = now_sec() - t0;
+        if (el > 0.5) {
+            fprintf(stderr, "\rlen %d: %zu/%zu words, %.0f words/s   ", len, done, job.nwords, (double)done / el);
+        }
+        usleep(500 * 1000);
+    }
+    for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+    double secs = now_sec() - t0;
+    bot_free(&lister);
+    if (job.failed) {
+        fprintf(stderr, "\nlen %d: a thread could not set up its bots.\n", len);
+        free(job.out);
+        return NULL;
+    }
+
+    qsort(job.out, job.nwords, sizeof(rank_rec_t), rank_rec_cmp);
+    fprintf(stderr, "\rlen %d: %zu words x %d games in %.1f s (%.0f games/s)      \n",
+            len, job.nwords, seeds, secs, secs > 0 ? (double)job.nwords * seeds / secs : 0.0);
+    *n_out = job.nwords;
+    return job.out;
+}
+
+static void print_word(const rank_rec_t *r, int len) {
+    char w[ENGINE_MAX_WORD_LEN + 1];
+    uint64_t v = r->key - 1;
+    for (int k = 0; k < len; k++) w[k] = (char)('A' + ((v >> (5 * k)) & 31u));
+    w[len] = '\0';
+    printf(" %s(%.1f)", w, (double)r->mean_guesses);
+}
+
+int main(int argc, char **argv) {
+    int only_len = 0;
+    int seeds = 8;
+    int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *dict_path = "dict.idx";
+    const char *out_path = "rank.idx";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l:s:t:d:o:")) != -1) {
+        switch (opt) {
+        case 'l': only_len = atoi(optarg); break;
+        case 's': seeds = atoi(optarg); break;
+        case 't': nthreads = atoi(optarg); break;
+        case 'd': dict_path = optarg; break;
+        case 'o': out_path = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-l word_len] [-s seeds] [-t threads] [-d dict.idx] [-o rank.idx]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    if (seeds < 1 || seeds > 10000) {
+        fprintf(stderr, "Seeds must be 1..10000.\n");
+        return 1;
+    }
+    if (only_len && !engine_len_supported(only_len)) {
+        fprintf(stderr, "Word length must be %d..%d.\n", ENGINE_MIN_WORD_LEN, ENGINE_MAX_WORD_LEN);
+        return 1;
+    }
+
+    dict_t dict;
+    if (dict_open(&dict, dict_path) != 0) {
+        fprintf(stderr, "Need %s (build it with dictbuild).\n", dict_path);
+        return 1;
+    }
+
+    rank_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = RANK_MAGIC;
+    hdr.seeds = (uint32_t)seeds;
+    rank_rec_t *recs[DICT_MAX_LEN + 1] = {0};
+    uint64_t off = sizeof(hdr);             // records start 8-byte aligned (rank.h)
+
+    for (int len = ENGINE_MIN_WORD_LEN; len <= ENGINE_MAX_WORD_LEN; len++) {
+        if ((only_len && len != only_len) || dict_count(&dict, len) == 0) continue;
+        size_t n = 0;
+        recs[len] = rank_length(&dict, len, seeds, nthreads, &n);
+        if (!recs[len]) return 1;
+        hdr.sec[len].offset = off;
+        hdr.sec[len].count = n;
+        off += n * sizeof(rank_rec_t);
+    }
+    dict_close(&dict);
+    if (off == sizeof(hdr)) {
+        fprintf(stderr, "No words to rank in %s.\n", dict_path);
+        return 1;
+    }
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", out_path);
+    FILE *out = fopen(tmp, "wb");
+    if (!out) { perror("fopen"); return 1; }
+    int err = fwrite(&hdr, sizeof(hdr), 1, out) != 1;
+    for (int len = 0; len <= DICT_MAX_LEN; len++) {
+        size_t n = (size_t)hdr.sec[len].count;
+        if (n) err |= fwrite(recs[len], sizeof(rank_rec_t), n, out) != n;
+    }
+    if (fclose(out) != 0) err = 1;
+    if (err || rename(tmp, out_path) != 0) { perror("write"); return 1; }
+
+    printf("Wrote %s (%d games per word)\n", out_path, seeds);
+    for (int len = 0; len <= DICT_MAX_LEN; len++) {
+        size_t n = (size_t)hdr.sec[len].count;
+        if (!n) continue;
+        const rank_rec_t *r = recs[len];
+        printf("  len %2d: %zu words, mean guesses %.1f (easiest) .. %.1f (median) .. %.1f (hardest)\n",
+               len, n, (double)r[0].mean_guesses, (double)r[n / 2].mean_guesses, (double)r[n - 1].mean_guesses);
+        printf("          easiest:");
+        for (size_t i = 0; i < n && i < 5; i++) print_word(&r[i], len);
+        printf("\n          hardest:");
+        for (size_t i = n > 5 ? n - 5 : 0; i < n; i++) print_word(&r[i], len);
+        printf("\n");
+        free(recs[len]);
+    }
+    return 0;
+}